@@ -0,0 +1,204 @@
+/*
+AStarImpl.hpp
+    - Implementation for A* between a start and find node and measures to feed into animation steps
+    - Nodes are settled by their weight from the start plus the heuristic's estimate of the weight left to the find node
+ */
+#pragma once
+#include <climits>
+#include "IAnimImpl.hpp"
+#include "heap.hpp"
+#include "heuristic.hpp"
+
+class AStarImpl : public IAnimImpl
+{
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    Node *curr;
+    const Node *start;
+    const Node *find;
+    IHeuristic *heuristic; // Estimates the weight left to the find node, owned by the algo
+
+    IndexedHeap<4> toVisit;            // Node indices that should eventually be visited keyed by weight plus estimate
+    std::vector<ll> dist;              // <dense index, weight from start> (-1 if unreached)
+    std::vector<uint32_t> parent;      // <dense index, node it was reached from> (NO_PARENT if start or unreached)
+    std::vector<uint8_t> nodesVisited; // <dense index, whether node has been visited>
+    std::vector<uint32_t> visitOrder;  // Dense indices in the order the steps visited them
+
+    // Saves new reachable nodes into vector to color at a step
+    // A consistent heuristic never lowers a visited node's weight, so visited nodes are skipped
+    void getNewReachableNodes(std::vector<Node *> &reachable)
+    {
+        assert(curr);
+        uint32_t currIdx = curr->getNodeIdx();
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
+        {
+            uint32_t childIdx = csr->targets[e];
+            if (nodesVisited[childIdx] || !csr->canTravel(e))
+                continue;
+
+            if (logSteps)
+                std::cout << "\t\tCan reach " << csr->nodes[childIdx]->getNodeIdent() << " @ step: " << currStep << std::endl;
+            reachable.push_back(csr->nodes[childIdx]);
+
+            ll newWeight = dist[currIdx] + csr->weights[e];
+            if (dist[childIdx] == -1 || newWeight < dist[childIdx])
+            {
+                dist[childIdx] = newWeight;
+                parent[childIdx] = currIdx;
+                toVisit.push(childIdx, newWeight + heuristic->estimate(childIdx));
+            }
+        }
+    }
+
+    // Formats the weight and estimate the step's node was visited with
+    std::string getStepMessage(const size_t &step) const override
+    {
+        if (step == 0 || step > visitOrder.size())
+            return "";
+
+        uint32_t idx = visitOrder[step - 1];
+        ll estimate = heuristic->estimate(idx);
+        return "Weight from start " + std::to_string(dist[idx]) + ", estimated " + std::to_string(estimate) + " more to find node (" + std::to_string(dist[idx] + estimate) + " total)";
+    }
+
+    // Nodes of the path from the start to the find node
+    std::vector<Node *> getPath() const
+    {
+        std::vector<Node *> path;
+        for (uint32_t idx = find->getNodeIdx(); idx != NO_PARENT; idx = parent[idx])
+            path.push_back(csr->nodes[idx]);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
+    {
+        if (!algoFinished)
+        {
+            if (!curr)
+            {
+                algoFinished = true;
+                addStepDescription(currStep, NULL, find, true, "Completed A* Algorithm");
+                std::cout << "\t\tFailed to complete algo\n";
+                return;
+            }
+
+            // Find node is visited, its path is colored as found
+            if (curr == find)
+            {
+                algoFinished = true;
+                addNodesToVec(VisNodesVec::current, getPath());
+                setFoundStep();
+                addStepDescription(currStep, NULL, find, false, "Shortest path weighs " + std::to_string(dist[curr->getNodeIdx()]));
+                std::cout << "\t\tFound node: " << curr->getNodeIdent() << std::endl;
+                return;
+            }
+
+            // Save current node before finding next curr and it's reachables
+            // Mark current node as visited
+            nodesVisited[curr->getNodeIdx()] = 1;
+            visitOrder.push_back(curr->getNodeIdx());
+            addNodeToVec(VisNodesVec::current, curr);
+
+            // Find new reachable and new curr nodes
+            std::vector<Node *> newReachableNodes;
+            getNewReachableNodes(newReachableNodes);
+            Node *newCurr = toVisit.empty() ? NULL : csr->nodes[toVisit.pop()];
+
+            // Save nodes reachable from curr node
+            // Mark curr node as visited so it will be visited on next forward click
+            addNodesToVec(VisNodesVec::reachable, newReachableNodes);
+            addNodeToVec(VisNodesVec::visited, curr);
+
+            // Add step description
+            addStepDescription(currStep, curr, NULL, false);
+
+            // Update curr to next curr
+            curr = newCurr;
+        }
+    }
+
+public:
+    AStarImpl()
+    {
+        curr = NULL;
+        start = NULL;
+        find = NULL;
+        heuristic = NULL;
+        currAlgo = AlgoToRun::AStar;
+    }
+
+    // Sets the estimate of the weight left to the find node, the algo takes ownership of it
+    // Must be called before setStartNodes
+    void setHeuristic(IHeuristic *h)
+    {
+        delete heuristic;
+        heuristic = h;
+    }
+
+    void setStartNodes(const std::vector<Node *> &nodes) override
+    {
+        assert(nodes.size() == 2);
+        assert(csr && heuristic);
+        start = nodes[0];
+        curr = nodes[0];
+        find = nodes[1];
+        heuristic->setTarget(csr, find->getNodeIdx());
+
+        size_t numNodes = csr->numNodes();
+        dist.assign(numNodes, -1);
+        parent.assign(numNodes, NO_PARENT);
+        nodesVisited.assign(numNodes, 0);
+        toVisit.reserve(numNodes);
+        dist[curr->getNodeIdx()] = 0;
+
+        // Add step description
+        addStepDescription(0, NULL, NULL, false, "Estimating " + std::to_string(heuristic->estimate(start->getNodeIdx())) + " from start to find node");
+    }
+
+    const AlgoResult &runToCompletion() override
+    {
+        assert(csr && start && heuristic);
+        resetResult();
+
+        // Own heap so the step heap is left as is
+        IndexedHeap<4> queue;
+        std::vector<uint8_t> visited(csr->numNodes(), 0);
+        uint32_t startIdx = start->getNodeIdx();
+        uint32_t findIdx = find->getNodeIdx();
+        result.dist[startIdx] = 0;
+        queue.push(startIdx, heuristic->estimate(startIdx));
+
+        while (!queue.empty())
+        {
+            uint32_t currIdx = queue.pop();
+            visited[currIdx] = 1;
+            result.visitOrder.push_back(csr->nodes[currIdx]);
+            if (currIdx == findIdx)
+            {
+                result.found = true;
+                break;
+            }
+
+            for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
+            {
+                uint32_t child = csr->targets[e];
+                ll newWeight = result.dist[currIdx] + csr->weights[e];
+                if (!visited[child] && csr->canTravel(e) && (result.dist[child] == -1 || newWeight < result.dist[child]))
+                {
+                    result.dist[child] = newWeight;
+                    result.parent[child] = csr->nodes[currIdx];
+                    queue.push(child, newWeight + heuristic->estimate(child));
+                }
+            }
+        }
+        return result;
+    }
+
+    ~AStarImpl() override
+    {
+        delete heuristic;
+    }
+};
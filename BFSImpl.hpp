@@ -6,6 +6,7 @@ BFSImpl.hpp
 #include <climits>
 #include <queue>
 #include "IAnimImpl.hpp"
+#include "directionBFS.hpp"
 
 class BFSImpl : public IAnimImpl
 {
@@ -13,14 +14,53 @@ private:
     Node *curr;
     const Node *start;
     const Node *find;
+    WorkStealingPool *pool; // Workers running to completion with direction optimizing BFS (NULL runs it with the queue)
 
     // Keeps track of steps for BFS
     std::queue<Node *> nextNodes;            // Child nodes to visit next
-    std::unordered_set<Node *> nodesVisited; // Nodes that have been visited
+    std::vector<uint8_t> nodesVisited;       // <dense index, whether node has been visited>
 
 private:
+    // Fills the result with direction optimizing BFS on the pool, levels, parents and visit order match the queue's
+    // The queue stops at the find node, so only the nodes it had visited before then keep the children they reached
+    const AlgoResult &runDirectionBFS()
+    {
+        std::vector<uint32_t> levels, parents, order;
+        DirectionOptimizingBFS bfs(*csr, *pool);
+        uint32_t findIdx = find->getNodeIdx();
+        bfs.run(start->getNodeIdx(), findIdx, levels);
+        bfs.parents(parents, order);
+
+        std::vector<uint8_t> expanded(csr->numNodes(), 0); // <dense index, whether the queue visited node before finding the find node>
+        for (uint32_t idx : order)
+        {
+            result.visitOrder.push_back(csr->nodes[idx]);
+            if (idx == findIdx)
+            {
+                result.found = true;
+                break;
+            }
+            expanded[idx] = 1;
+        }
+
+        result.dist[start->getNodeIdx()] = 0;
+        for (size_t i = 0; i < parents.size(); ++i)
+        {
+            if (parents[i] != DirectionOptimizingBFS::NO_PARENT && expanded[parents[i]])
+            {
+                result.dist[i] = levels[i];
+                result.parent[i] = csr->nodes[parents[i]];
+            }
+        }
+        return result;
+    }
+
+    // A node reachable from several visited nodes is queued once per parent, skip the copies already visited
     Node *getNewCurrNode()
     {
+        while (!nextNodes.empty() && nodesVisited[nextNodes.front()->getNodeIdx()])
+            nextNodes.pop();
+
         if (nextNodes.empty())
             return NULL;
 
@@ -33,56 +73,27 @@ private:
     // Saves all unvisited, travelable nodes in curr nodes adj list as reachable
     void getNewReachableNodes(std::vector<Node *> &reachable)
     {
-        const std::vector<ADJ_NODE> &links = curr->getNodeLinks();
+        uint32_t currIdx = curr->getNodeIdx();
 
-        for (const ADJ_NODE &link : links)
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
         {
-            Node *childNode = std::get<0>(link);
-            bool canTravel = std::get<3>(link);
+            Node *childNode = csr->nodes[csr->targets[e]];
 
-            if (!nodesVisited.count(childNode) && canTravel)
+            if (!nodesVisited[csr->targets[e]] && csr->canTravel(e))
             {
-                std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
+                if (logSteps)
+                    std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
                 reachable.push_back(childNode);
                 nextNodes.push(childNode);
             }
         }
     }
 
-public:
-    BFSImpl()
-    {
-        curr = NULL;
-        start = NULL;
-        find = NULL;
-        currAlgo = AlgoToRun::BFS;
-    }
-
-    void setStartNodes(const std::vector<Node *> &nodes) override
-    {
-        assert(nodes.size() == 2);
-        start = nodes[0];
-        curr = nodes[0];
-        find = nodes[1];
-
-        // Add start description
-        addStepDescription(0, NULL, NULL, false);
-    }
-
-    void stepForward() override
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
     {
         if (!algoFinished)
         {
-            // Uncolor border of previous curr node
-            // Uncolor previous reachable nodes
-            // Color previous curr node as visited
-            toggleCurrNodesBorderColor(currStep, false);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_UNTOUCHED_COLOR);
-            setVecNodesColor(VisNodesVec::visited, currStep, ANIM_NODE_VIS_COLOR);
-
-            // Go to next step
-            incCurrStep();
-
             // Null curr means no new nodes to traverse to
             if (!curr)
             {
@@ -98,17 +109,16 @@ public:
                 }
             }
 
-            // Color border of current node before finding next curr and it's reachables
+            // Save current node before finding next curr and it's reachables
             // Mark current node as visited
-            nodesVisited.insert(curr);
-            addNodesToVec(VisNodesVec::current, std::vector<Node *>{curr});
-            toggleCurrNodesBorderColor(currStep, true);
+            nodesVisited[curr->getNodeIdx()] = 1;
+            addNodeToVec(VisNodesVec::current, curr);
 
             // Check if curr is node to find before looking at children
             if (curr == find)
             {
                 algoFinished = true;
-                setVecNodesColor(VisNodesVec::current, currStep, ANIM_NODE_FOUND_COLOR);
+                setFoundStep();
                 addNodesToVec(VisNodesVec::reachable, std::vector<Node *>{});
                 addNodesToVec(VisNodesVec::visited, std::vector<Node *>{});
                 addStepDescription(currStep, curr, find, false);
@@ -121,11 +131,10 @@ public:
             getNewReachableNodes(newReachableNodes);
             Node *newCurr = getNewCurrNode();
 
-            // Color nodes reachable from curr node
+            // Save nodes reachable from curr node
             // Mark curr node as visited so it will be visited on next forward click
             addNodesToVec(VisNodesVec::reachable, newReachableNodes);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_REACHABLE_COLOR);
-            addNodesToVec(VisNodesVec::visited, std::vector<Node *>{curr});
+            addNodeToVec(VisNodesVec::visited, curr);
 
             // Add step description
             addStepDescription(currStep, curr, NULL, false);
@@ -135,5 +144,72 @@ public:
         }
     }
 
+public:
+    BFSImpl()
+    {
+        curr = NULL;
+        start = NULL;
+        find = NULL;
+        pool = NULL;
+        currAlgo = AlgoToRun::BFS;
+    }
+
+    // Runs to completion with parallel direction optimizing BFS on the pool's workers instead of the queue, NULL goes back to the queue
+    // Steps still use the queue
+    void setParallel(WorkStealingPool *workers)
+    {
+        pool = workers;
+    }
+
+    void setStartNodes(const std::vector<Node *> &nodes) override
+    {
+        assert(nodes.size() == 2);
+        assert(csr);
+        nodesVisited.assign(csr->numNodes(), 0);
+        start = nodes[0];
+        curr = nodes[0];
+        find = nodes[1];
+
+        // Add start description
+        addStepDescription(0, NULL, NULL, false);
+    }
+
+    const AlgoResult &runToCompletion() override
+    {
+        assert(csr && start);
+        resetResult();
+        if (pool)
+            return runDirectionBFS();
+
+        // nodes are marked reached when first queued so each is queued once
+        std::vector<uint32_t> frontier; // Queue of dense indices, popped by moving head
+        uint32_t startIdx = start->getNodeIdx();
+        result.dist[startIdx] = 0;
+        frontier.push_back(startIdx);
+
+        for (size_t head = 0; head < frontier.size(); ++head)
+        {
+            uint32_t currIdx = frontier[head];
+            result.visitOrder.push_back(csr->nodes[currIdx]);
+            if (csr->nodes[currIdx] == find)
+            {
+                result.found = true;
+                break;
+            }
+
+            for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
+            {
+                uint32_t child = csr->targets[e];
+                if (result.dist[child] == -1 && csr->canTravel(e))
+                {
+                    result.dist[child] = result.dist[currIdx] + 1;
+                    result.parent[child] = csr->nodes[currIdx];
+                    frontier.push_back(child);
+                }
+            }
+        }
+        return result;
+    }
+
     ~BFSImpl() override {}
 };
\ No newline at end of file
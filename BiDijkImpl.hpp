@@ -0,0 +1,258 @@
+/*
+BiDijkImpl.hpp
+    - Implementation for bidirectional Dijkstra between a start and find node and measures to feed into animation steps
+    - Searches forward from the start and backward from the find node in turns, stopping once no shorter path can be left
+ */
+#pragma once
+#include <climits>
+#include "IAnimImpl.hpp"
+#include "dijkQueue.hpp"
+
+class BiDijkImpl : public IAnimImpl
+{
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    // One direction of the search, forward searches from the start and backward searches links in reverse from the find node
+    struct Frontier
+    {
+        DijkQueue toVisit;            // Node indices to settle keyed by their weight
+        std::vector<ll> dist;         // <dense index, weight from the search's root> (-1 if unreached)
+        std::vector<uint32_t> parent; // <dense index, node it was reached from> (NO_PARENT if root or unreached)
+        std::vector<uint8_t> settled; // <dense index, whether node's weight is final>
+        ll lastKey;                   // Weight of the last settled node, never more than the smallest weight in toVisit
+
+        void init(size_t numNodes, DijkQueueType type, ll maxWeight, uint32_t root)
+        {
+            toVisit.setType(type, maxWeight);
+            dist.assign(numNodes, -1);
+            parent.assign(numNodes, NO_PARENT);
+            settled.assign(numNodes, 0);
+            lastKey = 0;
+
+            dist[root] = 0;
+            toVisit.push(root, 0);
+        }
+    };
+
+    // What a settling step did, formatted into the step description when it is read
+    struct StepInfo
+    {
+        bool backward;    // Whether the backward search settled the step's node
+        ll bestWeight;    // Shortest path weight found by the step (-1 if none yet)
+        uint32_t meetIdx; // Node the shortest path found passes through
+    };
+
+    const Node *start;
+    const Node *find;
+    ll maxLinkWeight;                // Bound on every link weight the queues are set up with
+    DijkQueueType queueType;         // Queue each search direction uses
+    Frontier searches[2];            // Forward then backward search of the steps
+    bool backwardTurn;               // Whether the backward search settles the next step
+    ll bestWeight;                   // Shortest path weight found so far (-1 if none)
+    uint32_t meetIdx;                // Node the shortest path found so far passes through
+    std::vector<StepInfo> stepInfos; // <step, what the step did>
+
+    // Settles the closest unsettled node of searches[side] and relaxes its links
+    // best and meet are lowered when a relaxed link joins the two searches into a shorter path
+    // Returns false instead once the search can stop, either side running out or the smallest weights of both sides adding up to at least best
+    bool settleNext(Frontier (&s)[2], int side, ll &best, uint32_t &meet, uint32_t &settledIdx, std::vector<Node *> *reachable) const
+    {
+        Frontier &f = s[side];
+        const Frontier &other = s[!side];
+        if (f.toVisit.empty())
+            return false;
+
+        uint32_t currIdx = f.toVisit.pop();
+        ll key = f.dist[currIdx];
+        if (best != -1 && key + other.lastKey >= best)
+            return false;
+
+        f.settled[currIdx] = 1;
+        f.lastKey = key;
+        settledIdx = currIdx;
+
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
+        {
+            // Backward search walks links from the linked node to curr
+            if (side ? !csr->canTravelBack(e) : !csr->canTravel(e))
+                continue;
+
+            uint32_t child = csr->targets[e];
+            ll newWeight = key + csr->weights[e];
+            if (other.dist[child] != -1 && (best == -1 || newWeight + other.dist[child] < best))
+            {
+                best = newWeight + other.dist[child];
+                meet = child;
+            }
+
+            if (f.settled[child])
+                continue;
+            if (reachable)
+                reachable->push_back(csr->nodes[child]);
+            if (f.dist[child] == -1 || newWeight < f.dist[child])
+            {
+                f.dist[child] = newWeight;
+                f.parent[child] = currIdx;
+                f.toVisit.push(child, newWeight);
+            }
+        }
+        return true;
+    }
+
+    // Nodes of the path through meet, from the start to the find node
+    std::vector<Node *> getPath(const Frontier (&s)[2], uint32_t meet) const
+    {
+        std::vector<Node *> path;
+        for (uint32_t idx = meet; idx != NO_PARENT; idx = s[0].parent[idx])
+            path.push_back(csr->nodes[idx]);
+        std::reverse(path.begin(), path.end());
+        for (uint32_t idx = s[1].parent[meet]; idx != NO_PARENT; idx = s[1].parent[idx])
+            path.push_back(csr->nodes[idx]);
+        return path;
+    }
+
+    // Formats which search settled the step's node and the shortest path known after it
+    std::string getStepMessage(const size_t &step) const override
+    {
+        if (step == 0 || step >= stepInfos.size())
+            return "";
+
+        const StepInfo &info = stepInfos[step];
+        std::stringstream ss;
+        ss << (info.backward ? "Searching back from node " : "Searching from node ");
+        ss << (info.backward ? find : start)->getNodeIdent();
+        if (info.bestWeight != -1)
+            ss << "\n\tShortest path so far weighs " << info.bestWeight << " through node " << csr->nodes[info.meetIdx]->getNodeIdent();
+        return ss.str();
+    }
+
+    // Ends the algorithm, coloring the shortest path as found if there is one
+    void finishSearch()
+    {
+        algoFinished = true;
+        if (bestWeight == -1)
+        {
+            addStepDescription(currStep, NULL, find, true, "Completed Bidirectional Dijkstra's Algorithm");
+            std::cout << "\t\tFailed to complete algo\n";
+            return;
+        }
+
+        addNodesToVec(VisNodesVec::current, getPath(searches, meetIdx));
+        setFoundStep();
+        addStepDescription(currStep, NULL, find, false, "Shortest path weighs " + std::to_string(bestWeight) + ", searches met at node " + std::to_string(csr->nodes[meetIdx]->getNodeIdent()));
+        std::cout << "Completed Bidirectional Dijkstra's Algorithm\n";
+    }
+
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
+    {
+        if (!algoFinished)
+        {
+            // Searches take turns settling a node
+            int side = backwardTurn;
+            backwardTurn = !backwardTurn;
+
+            uint32_t currIdx;
+            std::vector<Node *> newReachableNodes;
+            if (!settleNext(searches, side, bestWeight, meetIdx, currIdx, &newReachableNodes))
+            {
+                finishSearch();
+                return;
+            }
+
+            // Nodes settled backward are colored apart so both searches can be seen
+            Node *curr = csr->nodes[currIdx];
+            addNodeToVec(VisNodesVec::current, curr);
+            addNodesToVec(VisNodesVec::reachable, newReachableNodes);
+            addNodeToVec(side ? VisNodesVec::visitedBack : VisNodesVec::visited, curr);
+
+            // Add step description
+            assert(stepInfos.size() == currStep);
+            stepInfos.push_back(StepInfo{(bool)side, bestWeight, meetIdx});
+            addStepDescription(currStep, curr, NULL, false);
+        }
+    }
+
+public:
+    BiDijkImpl()
+    {
+        start = NULL;
+        find = NULL;
+        maxLinkWeight = 0;
+        queueType = DijkQueueType::Auto;
+        backwardTurn = false;
+        bestWeight = -1;
+        meetIdx = 0;
+        currAlgo = AlgoToRun::BiDijkstra;
+    }
+
+    // Picks the priority queue both searches use, maxWeight has to bound every link weight in the graph
+    // Must be called before setStartNodes
+    void setQueueType(const DijkQueueType type, const ll maxWeight)
+    {
+        queueType = type;
+        maxLinkWeight = maxWeight;
+    }
+
+    void setStartNodes(const std::vector<Node *> &nodes) override
+    {
+        assert(nodes.size() == 2);
+        assert(csr);
+        start = nodes[0];
+        find = nodes[1];
+
+        size_t numNodes = csr->numNodes();
+        searches[0].init(numNodes, queueType, maxLinkWeight, start->getNodeIdx());
+        searches[1].init(numNodes, queueType, maxLinkWeight, find->getNodeIdx());
+        if (start == find)
+        {
+            bestWeight = 0;
+            meetIdx = start->getNodeIdx();
+        }
+
+        // Add step description
+        stepInfos.push_back(StepInfo{false, bestWeight, meetIdx});
+        addStepDescription(0, NULL, NULL, false, "Priority queue: " + DijkQueueNames[(int)searches[0].toVisit.getType()]);
+    }
+
+    // Result holds the forward search's weights and parents plus the whole shortest path, visit order has the nodes settled by both searches
+    const AlgoResult &runToCompletion() override
+    {
+        assert(csr && start && find);
+        resetResult();
+
+        // Own searches so the step searches are left as is
+        Frontier s[2];
+        size_t numNodes = csr->numNodes();
+        s[0].init(numNodes, queueType, maxLinkWeight, start->getNodeIdx());
+        s[1].init(numNodes, queueType, maxLinkWeight, find->getNodeIdx());
+        ll best = start == find ? 0 : -1;
+        uint32_t meet = start->getNodeIdx();
+
+        uint32_t settledIdx;
+        for (int side = 0; settleNext(s, side, best, meet, settledIdx, NULL); side = !side)
+            result.visitOrder.push_back(csr->nodes[settledIdx]);
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            result.dist[i] = s[0].dist[i];
+            result.parent[i] = s[0].parent[i] == NO_PARENT ? NULL : csr->nodes[s[0].parent[i]];
+        }
+
+        // Continue the forward parents past meet along the backward search's parents
+        if (best != -1)
+        {
+            result.found = true;
+            for (uint32_t idx = meet; s[1].parent[idx] != NO_PARENT; idx = s[1].parent[idx])
+            {
+                uint32_t next = s[1].parent[idx];
+                result.parent[next] = csr->nodes[idx];
+                result.dist[next] = best - s[1].dist[next];
+            }
+        }
+        return result;
+    }
+
+    ~BiDijkImpl() override {}
+};
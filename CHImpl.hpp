@@ -0,0 +1,269 @@
+/*
+CHImpl.hpp
+    - Implementation for contraction hierarchy queries between a start and find node and measures to feed into animation steps
+    - Searches only upward from the start and only upward in reverse from the find node, the shortest path peaks where the two meet
+ */
+#pragma once
+#include <climits>
+#include <memory>
+#include "IAnimImpl.hpp"
+#include "contraction.hpp"
+
+class CHImpl : public IAnimImpl
+{
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    // One direction of the search, forward follows the up arcs from the start and backward follows the down arcs from the find node
+    struct Frontier
+    {
+        IndexedHeap<4> toVisit;          // Node indices to settle keyed by their weight
+        std::vector<ll> dist;            // <dense index, weight from the search's root> (-1 if unreached)
+        std::vector<uint32_t> parent;    // <dense index, node it was reached from> (NO_PARENT if root or unreached)
+        std::vector<uint32_t> parentMid; // <dense index, middle node of the arc it was reached by>
+        std::vector<uint8_t> settled;    // <dense index, whether node's weight is final>
+        bool done;                       // Whether nothing left in toVisit can shorten the path
+
+        void init(size_t numNodes, uint32_t root)
+        {
+            toVisit.clear();
+            toVisit.reserve(numNodes);
+            dist.assign(numNodes, -1);
+            parent.assign(numNodes, NO_PARENT);
+            parentMid.assign(numNodes, CH_NO_MID);
+            settled.assign(numNodes, 0);
+            done = false;
+
+            dist[root] = 0;
+            toVisit.push(root, 0);
+        }
+    };
+
+    // What a settling step did, formatted into the step description when it is read
+    struct StepInfo
+    {
+        bool backward;    // Whether the backward search settled the step's node
+        ll bestWeight;    // Shortest path weight found by the step (-1 if none yet)
+        uint32_t meetIdx; // Node the shortest path found passes through
+    };
+
+    const Node *start;
+    const Node *find;
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
+    Frontier searches[2];            // Forward then backward search of the steps
+    bool backwardTurn;               // Whether the backward search settles the next step
+    ll bestWeight;                   // Shortest path weight found so far (-1 if none)
+    uint32_t meetIdx;                // Node the shortest path found so far passes through
+    std::vector<StepInfo> stepInfos; // <step, what the step did>
+
+    // Settles the closest unsettled node of searches[side] and relaxes its arcs to higher ranked nodes
+    // best and meet are lowered when a relaxed arc joins the two searches into a shorter path
+    // Unlike bidirectional Dijkstra both sides have to pass best, the side that reaches the peak of the path first can't tell it apart
+    // Returns false instead once the side is done, either running out or its smallest weight reaching best
+    bool settleNext(Frontier (&s)[2], int side, ll &best, uint32_t &meet, uint32_t &settledIdx, std::vector<Node *> *reachable) const
+    {
+        Frontier &f = s[side];
+        const Frontier &other = s[!side];
+        if (f.done || f.toVisit.empty() || (best != -1 && f.toVisit.getKey(f.toVisit.top()) >= best))
+        {
+            f.done = true;
+            return false;
+        }
+
+        uint32_t currIdx = f.toVisit.pop();
+        ll key = f.dist[currIdx];
+        f.settled[currIdx] = 1;
+        settledIdx = currIdx;
+
+        const std::vector<uint32_t> &begin = side ? hierarchy->downBegin : hierarchy->upBegin;
+        const std::vector<CHArc> &arcs = side ? hierarchy->down : hierarchy->up;
+        for (uint32_t a = begin[currIdx]; a < begin[currIdx + 1]; ++a)
+        {
+            const CHArc &arc = arcs[a];
+            ll newWeight = key + arc.weight;
+            if (other.dist[arc.node] != -1 && (best == -1 || newWeight + other.dist[arc.node] < best))
+            {
+                best = newWeight + other.dist[arc.node];
+                meet = arc.node;
+            }
+
+            if (f.settled[arc.node])
+                continue;
+            if (reachable)
+                reachable->push_back(csr->nodes[arc.node]);
+            if (f.dist[arc.node] == -1 || newWeight < f.dist[arc.node])
+            {
+                f.dist[arc.node] = newWeight;
+                f.parent[arc.node] = currIdx;
+                f.parentMid[arc.node] = arc.mid;
+                f.toVisit.push(arc.node, newWeight);
+            }
+        }
+        return true;
+    }
+
+    // Settles a node on the side whose turn it is, or on the other side if that one is done
+    // Returns the side that settled a node, -1 once both are done
+    int settleEither(Frontier (&s)[2], int side, ll &best, uint32_t &meet, uint32_t &settledIdx, std::vector<Node *> *reachable) const
+    {
+        if (settleNext(s, side, best, meet, settledIdx, reachable))
+            return side;
+        if (settleNext(s, !side, best, meet, settledIdx, reachable))
+            return !side;
+        return -1;
+    }
+
+    // Original links of the path through meet from the start to the find node, each as <node it leads to, weight>
+    std::vector<CHArc> getPathArcs(const Frontier (&s)[2], uint32_t meet) const
+    {
+        // Forward arcs are collected from meet back to the start
+        std::vector<uint32_t> upward;
+        for (uint32_t idx = meet; s[0].parent[idx] != NO_PARENT; idx = s[0].parent[idx])
+            upward.push_back(idx);
+        std::reverse(upward.begin(), upward.end());
+
+        std::vector<CHArc> path;
+        for (uint32_t idx : upward)
+            unpackCHArc(*hierarchy, s[0].parent[idx], idx, s[0].parentMid[idx], s[0].dist[idx] - s[0].dist[s[0].parent[idx]], path);
+        for (uint32_t idx = meet; s[1].parent[idx] != NO_PARENT; idx = s[1].parent[idx])
+            unpackCHArc(*hierarchy, idx, s[1].parent[idx], s[1].parentMid[idx], s[1].dist[idx] - s[1].dist[s[1].parent[idx]], path);
+        return path;
+    }
+
+    // Formats which search settled the step's node and the shortest path known after it
+    std::string getStepMessage(const size_t &step) const override
+    {
+        if (step == 0 || step >= stepInfos.size())
+            return "";
+
+        const StepInfo &info = stepInfos[step];
+        std::stringstream ss;
+        ss << (info.backward ? "Searching up in reverse from node " : "Searching up from node ");
+        ss << (info.backward ? find : start)->getNodeIdent();
+        if (info.bestWeight != -1)
+            ss << "\n\tShortest path so far weighs " << info.bestWeight << " peaking at node " << csr->nodes[info.meetIdx]->getNodeIdent();
+        return ss.str();
+    }
+
+    // Ends the algorithm, coloring the unpacked shortest path as found if there is one
+    void finishSearch()
+    {
+        algoFinished = true;
+        if (bestWeight == -1)
+        {
+            addStepDescription(currStep, NULL, find, true, "Completed Contraction Hierarchy Query");
+            std::cout << "\t\tFailed to complete algo\n";
+            return;
+        }
+
+        std::vector<Node *> path{csr->nodes[start->getNodeIdx()]};
+        for (const CHArc &arc : getPathArcs(searches, meetIdx))
+            path.push_back(csr->nodes[arc.node]);
+        addNodesToVec(VisNodesVec::current, path);
+        setFoundStep();
+        addStepDescription(currStep, NULL, find, false, "Shortest path weighs " + std::to_string(bestWeight) + ", searches met at node " + std::to_string(csr->nodes[meetIdx]->getNodeIdent()));
+        std::cout << "Completed Contraction Hierarchy Query\n";
+    }
+
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
+    {
+        if (!algoFinished)
+        {
+            uint32_t currIdx;
+            std::vector<Node *> newReachableNodes;
+            int side = settleEither(searches, backwardTurn, bestWeight, meetIdx, currIdx, &newReachableNodes);
+            if (side == -1)
+            {
+                finishSearch();
+                return;
+            }
+            backwardTurn = !side;
+
+            // Nodes settled backward are colored apart so both searches can be seen
+            Node *curr = csr->nodes[currIdx];
+            addNodeToVec(VisNodesVec::current, curr);
+            addNodesToVec(VisNodesVec::reachable, newReachableNodes);
+            addNodeToVec(side ? VisNodesVec::visitedBack : VisNodesVec::visited, curr);
+
+            // Add step description
+            assert(stepInfos.size() == currStep);
+            stepInfos.push_back(StepInfo{(bool)side, bestWeight, meetIdx});
+            addStepDescription(currStep, curr, NULL, false);
+        }
+    }
+
+public:
+    CHImpl()
+    {
+        start = NULL;
+        find = NULL;
+        backwardTurn = false;
+        bestWeight = -1;
+        meetIdx = 0;
+        currAlgo = AlgoToRun::CH;
+    }
+
+    // Sets the hierarchy to search, it has to be built from the CSR the algo is given
+    // Must be called before setStartNodes
+    void setHierarchy(const std::shared_ptr<const ContractionHierarchy> &ch)
+    {
+        hierarchy = ch;
+    }
+
+    void setStartNodes(const std::vector<Node *> &nodes) override
+    {
+        assert(nodes.size() == 2);
+        assert(csr && hierarchy && hierarchy->numNodes == csr->numNodes());
+        start = nodes[0];
+        find = nodes[1];
+
+        size_t numNodes = csr->numNodes();
+        searches[0].init(numNodes, start->getNodeIdx());
+        searches[1].init(numNodes, find->getNodeIdx());
+        if (start == find)
+        {
+            bestWeight = 0;
+            meetIdx = start->getNodeIdx();
+        }
+
+        // Add step description
+        stepInfos.push_back(StepInfo{false, bestWeight, meetIdx});
+        addStepDescription(0, NULL, NULL, false, "Hierarchy has " + std::to_string(hierarchy->numShortcuts) + " shortcuts");
+    }
+
+    // Result holds the weights and parents along the unpacked shortest path, visit order has the nodes settled by both searches
+    const AlgoResult &runToCompletion() override
+    {
+        assert(csr && start && find && hierarchy);
+        resetResult();
+
+        // Own searches so the step searches are left as is
+        Frontier s[2];
+        size_t numNodes = csr->numNodes();
+        s[0].init(numNodes, start->getNodeIdx());
+        s[1].init(numNodes, find->getNodeIdx());
+        ll best = start == find ? 0 : -1;
+        uint32_t meet = start->getNodeIdx();
+
+        uint32_t settledIdx;
+        for (int side = settleEither(s, 0, best, meet, settledIdx, NULL); side != -1; side = settleEither(s, !side, best, meet, settledIdx, NULL))
+            result.visitOrder.push_back(csr->nodes[settledIdx]);
+
+        if (best != -1)
+        {
+            result.found = true;
+            uint32_t prev = start->getNodeIdx();
+            result.dist[prev] = 0;
+            for (const CHArc &arc : getPathArcs(s, meet))
+            {
+                result.dist[arc.node] = result.dist[prev] + arc.weight;
+                result.parent[arc.node] = csr->nodes[prev];
+                prev = arc.node;
+            }
+        }
+        return result;
+    }
+
+    ~CHImpl() override {}
+};
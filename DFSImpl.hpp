@@ -17,62 +17,22 @@ private:
     // Keeps track of the recursion for DFS
     // Contains all nodes that should be visited at a recursive layer
     std::stack<Node *> prevNodes;
-    std::unordered_set<Node *> nodesVisited; // All nodes that have been stepped into as a "curr" node
+    std::vector<uint8_t> nodesVisited; // <dense index, whether node has been stepped into as a "curr" node>
 
 private:
-    Node *getReachableAndNextCurr(const std::vector<ADJ_NODE> &adjNodes, std::vector<Node *> &reachable)
-    {
-        Node *nextCurr = NULL;
-
-        // Look at all adjacent nodes from curr node
-        for (size_t i = 0; i < adjNodes.size(); ++i)
-        {
-            Node *n = std::get<0>(adjNodes[i]);
-            // Node should never be null
-            assert(n);
-
-            bool canReach = std::get<3>(adjNodes[i]);
-            bool visited = nodesVisited.count(n);
-
-            if (canReach)
-            {
-                // Mark node as touched for clean up
-                setNodeTouched(n);
-
-                if (!visited && !nextCurr)
-                {
-                    // nextCurr set if we haven't visited
-                    nextCurr = n;
-                    nodesVisited.insert(nextCurr);                                     // Nodes that have been visited)
-                    std::cout << "\t\tNode " << n->getNodeIdent() << " is now curr\n"; // REMOVE
-                }
-                else if (!visited)
-                {
-                    // If adjacent reachable nodes have not been visited
-                    // then they are marked as reachable
-                    reachable.push_back(n);
-                    std::cout << "\t\tNode " << n->getNodeIdent() << " is now marked as reachable\n"; // REMOVE
-                }
-            }
-        }
-
-        return nextCurr;
-    }
-
     // Finds the new curr node from the current curr node's adjacency list
     Node *getNewCurrNode()
     {
-        const std::vector<ADJ_NODE> &links = curr->getNodeLinks();
+        uint32_t currIdx = curr->getNodeIdx();
 
-        for (const ADJ_NODE &link : links)
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
         {
-            Node *childNode = std::get<0>(link);
-            bool canTravel = std::get<3>(link);
+            uint32_t child = csr->targets[e];
 
-            if (!nodesVisited.count(childNode) && canTravel)
+            if (!nodesVisited[child] && csr->canTravel(e))
             {
                 // Unvisited node in list becomes node to visit and also mark it as visited
-                return childNode;
+                return csr->nodes[child];
             }
         }
         return NULL;
@@ -81,60 +41,29 @@ private:
     // Saves all unvisited, travelable nodes in curr nodes adj list as reachable
     void getNewReachableNodes(std::vector<Node *> &reachable)
     {
-        const std::vector<ADJ_NODE> &links = curr->getNodeLinks();
+        uint32_t currIdx = curr->getNodeIdx();
 
-        for (const ADJ_NODE &link : links)
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
         {
-            Node *childNode = std::get<0>(link);
-            bool canTravel = std::get<3>(link);
+            Node *childNode = csr->nodes[csr->targets[e]];
 
-            if (!nodesVisited.count(childNode) && canTravel)
+            if (!nodesVisited[csr->targets[e]] && csr->canTravel(e))
             {
-                std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
+                if (logSteps)
+                    std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
                 reachable.push_back(childNode);
             }
         }
     }
 
-public:
-    DFSImpl()
-    {
-        start = NULL;
-        find = NULL;
-        curr = NULL;
-        currAlgo = AlgoToRun::DFS;
-    }
-
-    // Passed in nodes assumed to be in order <start, find>
-    void setStartNodes(const std::vector<Node *> &nodes) override
-    {
-        // Make sure start and find nodes passed in
-        assert(nodes.size() == 2);
-        start = nodes[0];
-        curr = nodes[0];
-        find = nodes[1];
-
-        // Step description for step 0
-        addStepDescription(0, NULL, NULL, false);
-    }
-
-    void stepForward() override
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
     {
         // Description for steps
         std::string description = "";
 
         if (!algoFinished)
         {
-            // Uncolor border of previous curr node
-            // Uncolor previous reachable nodes
-            // Color previous curr node as visited
-            toggleCurrNodesBorderColor(currStep, false);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_UNTOUCHED_COLOR);
-            setVecNodesColor(VisNodesVec::visited, currStep, ANIM_NODE_VIS_COLOR);
-
-            // Go to next step
-            incCurrStep();
-
             if (!curr)
             {
                 // If current node is null try and recurse or end algo
@@ -155,22 +84,22 @@ public:
                     curr = prevNodes.top();
                     prevNodes.pop();
 
-                    std::cout << "\t\tRecursing to: " << curr->getNodeIdent() << std::endl;
+                    if (logSteps)
+                        std::cout << "\t\tRecursing to: " << curr->getNodeIdent() << std::endl;
                     description = "Recursing to: " + std::to_string(curr->getNodeIdent());
                 }
             }
 
-            // Color border of current node before finding next curr and it's reachables
+            // Save current node before finding next curr and it's reachables
             // Mark current node as visited
-            nodesVisited.insert(curr);
-            addNodesToVec(VisNodesVec::current, std::vector<Node *>{curr});
+            nodesVisited[curr->getNodeIdx()] = 1;
+            addNodeToVec(VisNodesVec::current, curr);
 
             // Check if curr node is node found
             if (curr == find)
             {
                 algoFinished = true;
-                toggleCurrNodesBorderColor(currStep, false);
-                setVecNodesColor(VisNodesVec::current, currStep, ANIM_NODE_FOUND_COLOR);
+                setFoundStep();
                 addNodesToVec(VisNodesVec::reachable, std::vector<Node *>{});
                 addNodesToVec(VisNodesVec::visited, std::vector<Node *>{});
                 addStepDescription(currStep, curr, find, false);
@@ -178,18 +107,14 @@ public:
                 return;
             }
 
-            // Color curr border color
-            toggleCurrNodesBorderColor(currStep, true);
-
             // Find the next curr and it's reachables if possible
             std::vector<Node *> newReachableNodes;
             getNewReachableNodes(newReachableNodes);
             Node *newCurr = getNewCurrNode();
 
-            // Color new reachable nodes and mark current node as visited
+            // Save new reachable nodes and mark current node as visited
             addNodesToVec(VisNodesVec::reachable, newReachableNodes);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_REACHABLE_COLOR);
-            addNodesToVec(VisNodesVec::visited, std::vector<Node *>{curr});
+            addNodeToVec(VisNodesVec::visited, curr);
 
             // Add step description
             addStepDescription(currStep, curr, NULL, false, description);
@@ -201,5 +126,72 @@ public:
         }
     }
 
+public:
+    DFSImpl()
+    {
+        start = NULL;
+        find = NULL;
+        curr = NULL;
+        currAlgo = AlgoToRun::DFS;
+    }
+
+    // Passed in nodes assumed to be in order <start, find>
+    void setStartNodes(const std::vector<Node *> &nodes) override
+    {
+        // Make sure start and find nodes passed in
+        assert(nodes.size() == 2);
+        assert(csr);
+        nodesVisited.assign(csr->numNodes(), 0);
+        start = nodes[0];
+        curr = nodes[0];
+        find = nodes[1];
+
+        // Step description for step 0
+        addStepDescription(0, NULL, NULL, false);
+    }
+
+    const AlgoResult &runToCompletion() override
+    {
+        assert(csr && start);
+        resetResult();
+
+        // Each stack entry resumes scanning its node's links where it left off
+        // Same visit order as stepForward, which rescans the links from the start
+        std::vector<std::pair<uint32_t, uint32_t>> path; // <dense index, next edge slot to scan>
+        uint32_t startIdx = start->getNodeIdx();
+        result.dist[startIdx] = 0;
+        result.visitOrder.push_back(csr->nodes[startIdx]);
+        result.found = start == find;
+        if (!result.found)
+            path.push_back(std::pair<uint32_t, uint32_t>(startIdx, csr->edgesBegin(startIdx)));
+
+        while (!path.empty())
+        {
+            uint32_t currIdx = path.back().first;
+            uint32_t e = path.back().second;
+            if (e >= csr->edgesEnd(currIdx))
+            {
+                path.pop_back();
+                continue;
+            }
+            path.back().second++;
+
+            uint32_t child = csr->targets[e];
+            if (result.dist[child] == -1 && csr->canTravel(e))
+            {
+                result.dist[child] = result.dist[currIdx] + 1;
+                result.parent[child] = csr->nodes[currIdx];
+                result.visitOrder.push_back(csr->nodes[child]);
+                if (csr->nodes[child] == find)
+                {
+                    result.found = true;
+                    break;
+                }
+                path.push_back(std::pair<uint32_t, uint32_t>(child, csr->edgesBegin(child)));
+            }
+        }
+        return result;
+    }
+
     ~DFSImpl() override {}
 };
\ No newline at end of file
@@ -5,6 +5,8 @@ DijkImpl.hpp
 #pragma once
 #include <climits>
 #include "IAnimImpl.hpp"
+#include "dijkQueue.hpp"
+#include "deltaStepping.hpp"
 
 class DijkImpl : public IAnimImpl
 {
@@ -14,103 +16,165 @@ private:
     Node *curr;
     const Node *start;
 
-    std::string weightMessage = ""; // Message for set description when getting new reachable nodes;
-
-    std::unordered_set<Node *> nodesVisited;          // Nodes that have been visited
-    std::unordered_map<Node *, CHILD_WEIGHT> toVisit; // Nodes that are should eventually be visited <Child Node, <weight from parent to child, Parent Node>> (Algo will end when this map is empty)
-    std::unordered_map<Node *, CHILD_WEIGHT> weights; // For displaying weight map table, <Child Node, <weight from parent to child, Parent Node>>
+    // Weight changes made when getting new reachable nodes, formatted into the step description when it is read
+    struct WeightChange
+    {
+        uint32_t parent; // Dense index of the curr node
+        uint32_t child;  // Dense index of the reachable node
+        ll linkWeight;
+        ll newWeight;
+        bool added; // Whether child got its first weight, otherwise its weight was lowered
+    };
+    std::vector<WeightChange> weightChanges; // Weight changes of all steps back to back
+    std::vector<uint32_t> weightChangeStarts; // <step, first weight change of the step>
+
+    ll maxLinkWeight;                  // Bound on every link weight the queue was set up with
+    WorkStealingPool *pool;            // Workers running to completion with delta-stepping (NULL runs it with the queue)
+    DijkQueue toVisit;                 // Node indices that should eventually be visited keyed by their weight (Algo will end when this queue is empty)
+    std::vector<uint8_t> nodesVisited; // <dense index, whether node has been visited>
+    std::vector<uint8_t> reached;      // <dense index, whether node has a weight yet>
+    std::vector<CHILD_WEIGHT> weights; // <dense index, <weight from start to node, Parent Node>>
 
     // Saves new reachable nodes into vector to color at a step
-    // Marks and updates weights as needed into both the toVisit and weights map
-    // NOTE: should run before getNewCurrNodes, to correctly have updated toVisit map
+    // Marks and updates weights as needed into both the toVisit queue and weights
+    // NOTE: should run before getNewCurrNodes, to correctly have updated toVisit queue
     void getNewReachableNodes(std::vector<Node *> &reachable)
     {
         assert(curr);
+        uint32_t currIdx = curr->getNodeIdx();
 
-        const std::vector<ADJ_NODE> &links = curr->getNodeLinks();
+        while (weightChangeStarts.size() <= currStep)
+            weightChangeStarts.push_back(weightChanges.size());
 
-        for (const ADJ_NODE &link : links)
+        for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
         {
-            std::stringstream ss;
-            Node *childNode = std::get<0>(link);
-            bool canTravel = std::get<3>(link);
+            uint32_t childIdx = csr->targets[e];
+            Node *childNode = csr->nodes[childIdx];
 
-            if (!nodesVisited.count(childNode) && canTravel)
+            if (!nodesVisited[childIdx] && csr->canTravel(e))
             {
                 // Save nodes to reachable vector to color
-                std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
+                if (logSteps)
+                    std::cout << "\t\tCan reach " << childNode->getNodeIdent() << " @ step: " << currStep << std::endl;
                 reachable.push_back(childNode);
 
                 // Get curr's weight and weight of link
-                const CHILD_WEIGHT &currWeight = weights[curr];
-                ll weight = std::get<1>(link);
+                const CHILD_WEIGHT &currWeight = weights[currIdx];
+                ll weight = csr->weights[e];
                 ll newWeight = std::get<0>(currWeight) + weight;
 
-                // If unvisited, reachable child node in weights
+                // If unvisited, reachable child node has a weight
                 // Use existing weights to determine if weights & parent node needs to be updated
-                if (weights.count(childNode))
+                if (reached[childIdx])
                 {
-                    assert(toVisit.count(childNode) != 0); // Shouldn't fail because child node needs to be unvisited to be in toVisit
-
-                    // Determine weight from curr node to child node
-                    const CHILD_WEIGHT &childWeight = toVisit[childNode];
+                    assert(toVisit.contains(childIdx)); // Shouldn't fail because child node needs to be unvisited to be in toVisit
 
                     // Update weights to child if new path leads to smaller weight, otherwise keep old path
-                    if (newWeight < std::get<0>(childWeight))
+                    if (toVisit.push(childIdx, newWeight))
                     {
                         // Add extra description and push to dijk table visualizer
-                        ss << "Updating " << curr->getNodeIdent() << "->" << childNode->getNodeIdent() << " weight from " << weight << " to " << newWeight << "\n\t";
+                        weightChanges.push_back(WeightChange{currIdx, childIdx, weight, newWeight, false});
                         addToDijkTable(childNode->getNodeIdent(), std::tuple<ll, Node *>(newWeight, curr));
 
-                        std::get<0>(toVisit[childNode]) = newWeight;
-                        std::get<1>(toVisit[childNode]) = curr;
-                        std::get<0>(weights[childNode]) = newWeight;
-                        std::get<1>(weights[childNode]) = curr;
+                        weights[childIdx] = std::tuple<ll, Node *>{newWeight, curr};
                     }
-
-                    weightMessage += ss.str();
                 }
                 else
                 {
                     // Add extra description and push to dijk table visualizer
-                    ss << "Adding " << curr->getNodeIdent() << "->" << childNode->getNodeIdent() << " weight as " << newWeight << "\n\t";
-                    weightMessage += ss.str();
+                    weightChanges.push_back(WeightChange{currIdx, childIdx, weight, newWeight, true});
                     addToDijkTable(childNode->getNodeIdent(), std::tuple<ll, Node *>(newWeight, curr));
 
                     // Store weights for the first time from curr to child node
-                    toVisit.emplace(childNode, std::tuple<ll, Node *>{newWeight, curr});
-                    weights.emplace(childNode, std::tuple<ll, Node *>{newWeight, curr});
+                    toVisit.push(childIdx, newWeight);
+                    reached[childIdx] = 1;
+                    weights[childIdx] = std::tuple<ll, Node *>{newWeight, curr};
                 }
             }
         }
     }
 
+    // Formats the weight changes made at step
+    std::string getStepMessage(const size_t &step) const override
+    {
+        if (step >= weightChangeStarts.size())
+            return "";
+
+        std::stringstream ss;
+        uint32_t end = step + 1 < weightChangeStarts.size() ? weightChangeStarts[step + 1] : weightChanges.size();
+        for (uint32_t i = weightChangeStarts[step]; i < end; ++i)
+        {
+            const WeightChange &change = weightChanges[i];
+            ll parentId = csr->nodes[change.parent]->getNodeIdent();
+            ll childId = csr->nodes[change.child]->getNodeIdent();
+            if (change.added)
+                ss << "Adding " << parentId << "->" << childId << " weight as " << change.newWeight << "\n\t";
+            else
+                ss << "Updating " << parentId << "->" << childId << " weight from " << change.linkWeight << " to " << change.newWeight << "\n\t";
+        }
+        return ss.str();
+    }
+
     // Returns the new curr node or null if algorithm has ended
-    // New curr node is determined as the node in toVisit with the smallest weight
+    // New curr node is the node in toVisit with the smallest weight
     Node *getNewCurrNode()
     {
         if (toVisit.empty())
             return NULL;
 
-        Node *newCurr = NULL;
-        ll smallestWeight = -1;
+        // Popping removes new curr from toVisit as that will be next curr
+        return csr->nodes[toVisit.pop()];
+    }
 
-        // Loop through entire toVisit map for the node with the smallest weight
-        for (auto it = toVisit.begin(); it != toVisit.end(); ++it)
+    // Runs the next step, colors are set from the saved step by IAnimImpl
+    void runStep() override
+    {
+        if (!algoFinished)
         {
-            const CHILD_WEIGHT &childWeight = it->second;
-            if (smallestWeight == -1 || smallestWeight > std::get<0>(childWeight))
+            if (!curr)
             {
-                newCurr = it->first;
-                smallestWeight = std::get<0>(childWeight);
+                algoFinished = true;
+                addStepDescription(currStep, NULL, NULL, false, "Completed Dijkstra's Algorithm");
+                std::cout << "Completed Dijkstra's Algorithm\n";
+                return;
             }
-        }
 
-        // Remove new curr from toVisit as that will be next curr
-        if (newCurr)
-            toVisit.erase(newCurr);
+            // Save current node before finding next curr and it's reachables
+            // Mark current node as visited
+            nodesVisited[curr->getNodeIdx()] = 1;
+            addNodeToVec(VisNodesVec::current, curr);
 
-        return newCurr;
+            // Find new reachable and new curr nodes
+            std::vector<Node *> newReachableNodes;
+            getNewReachableNodes(newReachableNodes);
+            Node *newCurr = getNewCurrNode();
+
+            // Save nodes reachable from curr node
+            // Mark curr node as visited so it will be visited on next forward click
+            addNodesToVec(VisNodesVec::reachable, newReachableNodes);
+            addNodeToVec(VisNodesVec::visited, curr);
+
+            // Add step description
+            addStepDescription(currStep, curr, NULL, false);
+
+            // Update curr to next curr
+            curr = newCurr;
+        }
+    }
+
+    // Fills the result with delta-stepping on the pool, weights, parents and visit order match the queue's
+    const AlgoResult &runDeltaStepping()
+    {
+        std::vector<uint32_t> parents, order;
+        DeltaStepping ds(*csr, *pool, DeltaStepping::pickDelta(*csr, maxLinkWeight));
+        ds.run(start->getNodeIdx(), maxLinkWeight, result.dist, parents, order);
+
+        for (size_t i = 0; i < parents.size(); ++i)
+            result.parent[i] = parents[i] == UINT32_MAX ? NULL : csr->nodes[parents[i]];
+        result.visitOrder.reserve(order.size());
+        for (uint32_t idx : order)
+            result.visitOrder.push_back(csr->nodes[idx]);
+        return result;
     }
 
 public:
@@ -118,70 +182,82 @@ public:
     {
         curr = NULL;
         start = NULL;
+        maxLinkWeight = 0;
+        pool = NULL;
         currAlgo = AlgoToRun::BFS;
     }
 
+    // Runs to completion with parallel delta-stepping on the pool's workers instead of the queue, NULL goes back to the queue
+    // Steps still use the queue
+    void setParallel(WorkStealingPool *workers)
+    {
+        pool = workers;
+    }
+
+    // Picks the priority queue used for toVisit, maxWeight has to bound every link weight in the graph
+    // Must be called before setStartNodes
+    void setQueueType(const DijkQueueType type, const ll maxWeight)
+    {
+        maxLinkWeight = maxWeight;
+        toVisit.setType(type, maxLinkWeight);
+    }
+
     void setStartNodes(const std::vector<Node *> &nodes) override
     {
         assert(nodes.size() == 1);
+        assert(csr);
         start = nodes[0];
         curr = nodes[0];
 
-        // Save start node in weights map
+        size_t numNodes = csr->numNodes();
+        nodesVisited.assign(numNodes, 0);
+        reached.assign(numNodes, 0);
+        weights.assign(numNodes, std::tuple<ll, Node *>{-1, NULL});
+
+        // Save start node in weights
         // Weight to curr is 0 and it has no parents
-        weights.emplace(curr, std::tuple<ll, Node *>{0, NULL});
+        reached[curr->getNodeIdx()] = 1;
+        weights[curr->getNodeIdx()] = std::tuple<ll, Node *>{0, NULL};
 
         // Add step description
-        addStepDescription(0, NULL, NULL, false);
+        addStepDescription(0, NULL, NULL, false, "Priority queue: " + DijkQueueNames[(int)toVisit.getType()]);
         addToDijkTable(curr->getNodeIdent(), std::tuple<ll, Node *>(0, NULL));
     }
 
-    void stepForward() override
+    const AlgoResult &runToCompletion() override
     {
-        weightMessage = "";
-        if (!algoFinished)
+        assert(csr && start);
+        resetResult();
+        if (pool)
+            return runDeltaStepping();
+
+        // Own queue of the same type so the step queue is left as is
+        DijkQueue queue;
+        queue.setType(toVisit.getType(), maxLinkWeight);
+        uint32_t startIdx = start->getNodeIdx();
+        result.dist[startIdx] = 0;
+        queue.push(startIdx, 0);
+
+        // A popped node's weight is final so it is never pushed again
+        // Like the steps, a child keeps the first parent that lowered it to its weight
+        while (!queue.empty())
         {
-            // Uncolor border of previous curr node
-            // Uncolor previous reachable nodes
-            // Color previous curr node as visited
-            toggleCurrNodesBorderColor(currStep, false);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_UNTOUCHED_COLOR);
-            setVecNodesColor(VisNodesVec::visited, currStep, ANIM_NODE_VIS_COLOR);
-
-            // Go to next step
-            incCurrStep();
+            uint32_t currIdx = queue.pop();
+            result.visitOrder.push_back(csr->nodes[currIdx]);
 
-            if (!curr)
+            for (uint32_t e = csr->edgesBegin(currIdx); e < csr->edgesEnd(currIdx); ++e)
             {
-                algoFinished = true;
-                addStepDescription(currStep, NULL, NULL, false, "Completed Dijkstra's Algorithm");
-                std::cout << "Completed Dijkstra's Algorithm\n";
-                return;
+                uint32_t child = csr->targets[e];
+                ll newWeight = result.dist[currIdx] + csr->weights[e];
+                if (csr->canTravel(e) && (result.dist[child] == -1 || newWeight < result.dist[child]))
+                {
+                    result.dist[child] = newWeight;
+                    result.parent[child] = csr->nodes[currIdx];
+                    queue.push(child, newWeight);
+                }
             }
-
-            // Color border of current node before finding next curr and it's reachables
-            // Mark current node as visited
-            nodesVisited.insert(curr);
-            addNodesToVec(VisNodesVec::current, std::vector<Node *>{curr});
-            toggleCurrNodesBorderColor(currStep, true);
-
-            // Find new reachable and new curr nodes
-            std::vector<Node *> newReachableNodes;
-            getNewReachableNodes(newReachableNodes);
-            Node *newCurr = getNewCurrNode();
-
-            // Color nodes reachable from curr node
-            // Mark curr node as visited so it will be visited on next forward click
-            addNodesToVec(VisNodesVec::reachable, newReachableNodes);
-            setVecNodesColor(VisNodesVec::reachable, currStep, ANIM_NODE_REACHABLE_COLOR);
-            addNodesToVec(VisNodesVec::visited, std::vector<Node *>{curr});
-
-            // Add step description
-            addStepDescription(currStep, curr, NULL, false, weightMessage);
-
-            // Update curr to next curr
-            curr = newCurr;
         }
+        return result;
     }
 
     ~DijkImpl() override {}
@@ -4,14 +4,20 @@ algoAnimation.hpp
  */
 #pragma once
 #include "graph.hpp"
+#include "stepLog.hpp"
 #include <sstream>
+#include <algorithm>
+#include <chrono>
 
-const std::string AlgoNames[] = {"DFS", "BFS", "Dijkstra", "No algorithm"};
+const std::string AlgoNames[] = {"DFS", "BFS", "Dijkstra", "Bidirectional Dijkstra", "A*", "Contraction Hierarchy", "No algorithm"};
 enum AlgoToRun
 {
     DFS,
     BFS,
     Dijkstra,
+    BiDijkstra,
+    AStar,
+    CH,
     NoAlgo
 };
 enum AlgoAnimationMode
@@ -19,18 +25,31 @@ enum AlgoAnimationMode
     Pause,
     Play,
     Close
-}; // TODO: forward, backward (necessary??)
+};
 
 #define ANIM_NODE_FOUND_COLOR sf::Color(0, 255, 0)       // green
 #define ANIM_NODE_VIS_COLOR sf::Color(0, 0, 0)           // black
 #define ANIM_NODE_REACHABLE_COLOR sf::Color(255, 138, 0) // orange
+#define ANIM_NODE_VIS_BACK_COLOR sf::Color(40, 60, 160)   // dark blue
 
 #define ANIM_NODE_BORDER_CURR_COLOR ANIM_NODE_FOUND_COLOR
 #define ANIM_NODE_UNTOUCHED_COLOR NODE_FILL_COLOR
 #define ANIM_NODE_BORDER_UNTOUCHED_COLOR NODE_OUT_COLOR
 
+#define ANIM_MIN_CHECKPOINT_INTERVAL 64      // Fewest steps between two saved node color states
+#define ANIM_CHECKPOINT_MAX_BYTES (16 << 20) // Memory the saved node color states can take before the steps between them double
+
 typedef std::tuple<ll, Node *> CHILD_WEIGHT; // <Child, Weight between child and parent, Parent>
 
+// Result of running an algorithm to completion without animating it
+struct AlgoResult
+{
+    std::vector<ll> dist;           // <dense index, distance from start> (-1 if unreached) - hops for BFS, depth in the DFS tree, path weight for Dijkstra
+    std::vector<Node *> parent;     // <dense index, node it was reached from> (NULL for start and unreached nodes)
+    std::vector<Node *> visitOrder; // Nodes in the order they were visited
+    bool found;                     // Whether the find node was visited (BFS/DFS)
+};
+
 class IAnimImpl
 {
 protected:
@@ -38,26 +57,81 @@ protected:
     size_t allSteps;    // Total number of steps currently ran
     AlgoToRun currAlgo; // Current algo that is running - TODO: tbd necessary?
     bool algoFinished;  // Indicate that we have reached the last step and the algo is finished
+    const GraphCSR *csr; // Link store of the graph the algorithm traverses
 
     // For visualizing node steps
-    // <step index, nodes at that time>
+    // Log of the current node(s) algorithm is on, nodes that can be visited and nodes marked visited at each step
     // NOTE: visited nodes are cumulative over steps
     // e.g. <0, <N1>>, <1, <N2, N3>>. This means by step 1, nodes 1,2, and 3 have all been visited
-    std::vector<std::vector<Node *>> currNodes;      // Current node(s) algorithm is on
-    std::vector<std::vector<Node *>> reachableNodes; // Nodes that can be visited at current iteration
-    std::vector<std::vector<Node *>> visitedNodes;   // All nodes that have been visited at current step
+    StepLog stepLog;
+    size_t vecSteps[4]; // <VisNodesVec, number of steps the vec has been set for>
+
+    // What a step's description is made of, the text is only formatted when the description is read
+    struct StepNote
+    {
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+        uint32_t step;
+        uint32_t curr;         // Dense index of node the step is on (NO_NODE if none)
+        uint32_t find;         // Dense index of node to find (NO_NODE if none)
+        bool failed;           // Whether the find node failed to be found
+        bool listsReachable;   // Whether the step's reachable nodes were set when it was described
+        uint32_t messageBegin; // Additional message is noteMessages[messageBegin, messageEnd)
+        uint32_t messageEnd;
+    };
 
     // For step and data visualization
-    std::vector<std::string> stepDescription; // Descriptions for each step
-    std::map<ll, CHILD_WEIGHT> dijkTable;     // Dijkstra weight table <Child ID, <parent to child weight, Parent node>>
+    std::vector<StepNote> stepNotes;      // Description parts for each step
+    std::string noteMessages;             // Additional messages of all steps back to back
+    std::map<ll, CHILD_WEIGHT> dijkTable; // Dijkstra weight table <Child ID, <parent to child weight, Parent node>>
+
+    // For running to completion, kept apart from the step data so the timeline can still be built afterwards
+    AlgoResult result;
+
+    // For stepping backward and seeking
+    // Node colors are kept as a state per node, fill (AnimFill) in the low 3 bits and current border in bit 3
+    // A step is shown by moving to the closest checkpoint before it and replaying the logged steps after it
+    // Checkpoints only keep the nodes that changed since the one before, so moving between them costs the nodes that changed
+    enum AnimFill
+    {
+        FillUntouched,
+        FillVisited,
+        FillReachable,
+        FillFound,
+        FillVisitedBack
+    };
+    static constexpr uint8_t FILL_MASK = 7;
+    static constexpr uint8_t BORDER_CURR = 8;
+    static constexpr uint32_t NOT_IN_DIFF = UINT32_MAX;
 
-    enum class VisNodesVec
+    // Nodes whose state changed between two steps, with their state at the first and at the second
+    struct StateDiff
     {
-        current,
-        reachable,
-        visited
+        std::vector<uint32_t> nodes;
+        std::vector<uint8_t> before;
+        std::vector<uint8_t> after;
+
+        inline size_t bytes() const
+        {
+            return nodes.size() * (sizeof(uint32_t) + 2);
+        }
     };
 
+    std::vector<uint8_t> nodeStates;   // <dense index, state node is colored as>
+    std::vector<StateDiff> checkpoints; // <checkpoint, changes from the checkpoint before to step checkpoint * checkpointInterval> (checkpoint 0 is every node uncolored)
+    StateDiff pending;                  // Changes from the last checkpoint to the last step ran, only before is kept until it is saved as a checkpoint
+    std::vector<uint8_t> inPending;     // <dense index, whether index is in pending>
+    std::vector<uint32_t> diffPos;      // <dense index, position in the diff being merged> (NOT_IN_DIFF otherwise)
+    bool recordPending;                 // Whether state changes are new steps being ran, only those go into pending
+    size_t checkpointBytes;             // Memory taken by the checkpoints' changes
+    size_t checkpointInterval;          // Steps between checkpoints, doubled to keep about sqrt(steps) of them within ANIM_CHECKPOINT_MAX_BYTES
+    size_t foundStep;                   // Step the find node was found at (SIZE_MAX if not found)
+
+    // Node colors are only set on the nodes once a step or batch of steps is done
+    std::vector<uint32_t> dirtyNodes; // Dense indices whose state changed since colors were last applied
+    std::vector<uint8_t> isDirty;     // <dense index, whether index is in dirtyNodes>
+    bool logSteps;                    // Whether each step is logged to the console, off while playing many steps a frame
+
     // For clean up
     std::unordered_set<Node *> touched; // All nodes that have been touched to be cleaned after algo finishes
 
@@ -75,30 +149,32 @@ protected:
         // AllSteps should gets updated when currstep matches total number of steps
         if (currStep >= allSteps)
             allSteps++;
-        std::cout << "Curr step incr to " << currStep << "/" << allSteps << std::endl;
+        if (logSteps)
+            std::cout << "Curr step incr to " << currStep << "/" << allSteps << std::endl;
     }
 
-    // Add a vector of nodes to a given visualizing nodes vector
-    void addNodesToVec(const VisNodesVec vecType, std::vector<Node *> nodes, bool markTouched = true)
+    // Sets the nodes of a given visualizing nodes vector at the current step
+    void addNodesToVec(const VisNodesVec vecType, const std::vector<Node *> &nodes, bool markTouched = true)
     {
-        switch (vecType)
-        {
-        case VisNodesVec::current:
-            currNodes.push_back(nodes);
-            break;
-        case VisNodesVec::reachable:
-            reachableNodes.push_back(nodes);
-            break;
-        case VisNodesVec::visited:
-            visitedNodes.push_back(nodes);
-            break;
-        }
+        vecSteps[(int)vecType]++;
+        for (Node *n : nodes)
+            stepLog.add(currStep, vecType, n->getNodeIdx());
 
         // Mark added nodes to the touched map
         if (markTouched)
             setNodesTouched(nodes);
     }
 
+    // Sets a single node as a given visualizing nodes vector at the current step
+    void addNodeToVec(const VisNodesVec vecType, Node *node, bool markTouched = true)
+    {
+        vecSteps[(int)vecType]++;
+        stepLog.add(currStep, vecType, node->getNodeIdx());
+
+        if (markTouched)
+            setNodeTouched(node);
+    }
+
     // Checks and marks each node as touched
     void setNodesTouched(const std::vector<Node *> &nodes)
     {
@@ -117,86 +193,325 @@ protected:
         }
     }
 
-    // Sets every node in the given vis vec at the given step to the given color
-    void setVecNodesColor(const VisNodesVec vecType, const size_t &step, const sf::Color &color)
+    // Sets the state of the node at idx, its colors are set by applyNodeStates
+    void setNodeState(uint32_t idx, uint8_t state)
     {
-        assert(allSteps > step && step >= 0);
-        std::vector<Node *> nodes;
+        if (nodeStates[idx] == state)
+            return;
 
-        switch (vecType)
+        if (recordPending && !inPending[idx])
+        {
+            inPending[idx] = 1;
+            pending.nodes.push_back(idx);
+            pending.before.push_back(nodeStates[idx]);
+        }
+        nodeStates[idx] = state;
+        if (!isDirty[idx])
         {
-        case VisNodesVec::current:
-            assert(currNodes.size() > step);
-            nodes = currNodes[step];
-            break;
-        case VisNodesVec::reachable:
-            assert(reachableNodes.size() > step);
-            nodes = reachableNodes[step];
-            break;
-        case VisNodesVec::visited:
-            assert(visitedNodes.size() > step);
-            nodes = visitedNodes[step];
-            break;
+            isDirty[idx] = 1;
+            dirtyNodes.push_back(idx);
         }
+    }
 
-        for (Node *n : nodes)
+    // Colors every node whose state changed as its current state
+    void applyNodeStates()
+    {
+        for (uint32_t idx : dirtyNodes)
         {
+            Node *n = csr->nodes[idx];
             assert(n);
-            n->setNodeFillColor(color);
+            switch (nodeStates[idx] & FILL_MASK)
+            {
+            case FillUntouched:
+                n->setNodeFillColor(ANIM_NODE_UNTOUCHED_COLOR);
+                break;
+            case FillVisited:
+                n->setNodeFillColor(ANIM_NODE_VIS_COLOR);
+                break;
+            case FillReachable:
+                n->setNodeFillColor(ANIM_NODE_REACHABLE_COLOR);
+                break;
+            case FillFound:
+                n->setNodeFillColor(ANIM_NODE_FOUND_COLOR);
+                break;
+            case FillVisitedBack:
+                n->setNodeFillColor(ANIM_NODE_VIS_BACK_COLOR);
+                break;
+            }
+            n->setNodeOutlineColor((nodeStates[idx] & BORDER_CURR) ? ANIM_NODE_BORDER_CURR_COLOR : ANIM_NODE_BORDER_UNTOUCHED_COLOR);
+            isDirty[idx] = 0;
+        }
+        dirtyNodes.clear();
+    }
+
+    // Sets the fill of every node in the given vis vec at the given step
+    void setVecNodesFill(const VisNodesVec vecType, const size_t &step, const AnimFill fill)
+    {
+        assert(allSteps > step && step >= 0);
+        for (uint32_t e = stepLog.stepBegin(step); e < stepLog.stepEnd(step); ++e)
+        {
+            if (stepLog.state(e) == vecType)
+            {
+                uint32_t idx = stepLog.node(e);
+                setNodeState(idx, (nodeStates[idx] & BORDER_CURR) | fill);
+            }
         }
     }
 
     // Sets the border color of the curr node at step to be on if onCurr is true
-    void toggleCurrNodesBorderColor(const size_t &step, bool onCurr)
+    void toggleCurrNodesBorder(const size_t &step, bool onCurr)
     {
         assert(allSteps > step && step >= 0);
-        assert(currNodes.size() >= step);
+        for (uint32_t e = stepLog.stepBegin(step); e < stepLog.stepEnd(step); ++e)
+        {
+            if (stepLog.state(e) == VisNodesVec::current)
+            {
+                uint32_t idx = stepLog.node(e);
+                setNodeState(idx, (nodeStates[idx] & FILL_MASK) | (onCurr ? BORDER_CURR : 0));
+            }
+        }
+    }
 
-        std::vector<Node *> nodes;
-        nodes = currNodes[step];
-        const sf::Color color = onCurr ? ANIM_NODE_BORDER_CURR_COLOR : ANIM_NODE_BORDER_UNTOUCHED_COLOR;
-        for (Node *n : nodes)
+    // Colors the nodes from how they are at step - 1 to how they are at step
+    void colorStep(const size_t &step)
+    {
+        assert(step > 0);
+
+        // Uncolor border of previous curr node
+        // Uncolor previous reachable nodes
+        // Color previous curr node as visited
+        toggleCurrNodesBorder(step - 1, false);
+        setVecNodesFill(VisNodesVec::reachable, step - 1, FillUntouched);
+        setVecNodesFill(VisNodesVec::visited, step - 1, FillVisited);
+        setVecNodesFill(VisNodesVec::visitedBack, step - 1, FillVisitedBack);
+
+        // Color border of current node and the nodes reachable from it
+        toggleCurrNodesBorder(step, true);
+        setVecNodesFill(VisNodesVec::reachable, step, FillReachable);
+        if (step == foundStep)
+            setVecNodesFill(VisNodesVec::current, step, FillFound);
+    }
+
+    // Step 0 has every node uncolored
+    void initCheckpoints()
+    {
+        assert(csr);
+        nodeStates.assign(csr->numNodes(), 0);
+        isDirty.assign(csr->numNodes(), 0);
+        dirtyNodes.clear();
+        checkpoints.assign(1, StateDiff());
+        pending = StateDiff();
+        inPending.assign(csr->numNodes(), 0);
+        diffPos.assign(csr->numNodes(), NOT_IN_DIFF);
+        checkpointBytes = 0;
+        checkpointInterval = ANIM_MIN_CHECKPOINT_INTERVAL;
+    }
+
+    // Sets the nodes of a diff to their state before or after it
+    void applyDiff(const StateDiff &diff, bool after)
+    {
+        const std::vector<uint8_t> &states = after ? diff.after : diff.before;
+        for (size_t i = 0; i < diff.nodes.size(); ++i)
+            setNodeState(diff.nodes[i], states[i]);
+    }
+
+    // Changes of first followed by second, nodes that end up as they started are left out
+    void mergeDiffs(const StateDiff &first, const StateDiff &second, StateDiff &out)
+    {
+        out = first;
+        for (size_t i = 0; i < first.nodes.size(); ++i)
+            diffPos[first.nodes[i]] = i;
+        for (size_t i = 0; i < second.nodes.size(); ++i)
         {
-            assert(n);
-            n->setNodeOutlineColor(color);
+            uint32_t idx = second.nodes[i];
+            if (diffPos[idx] != NOT_IN_DIFF)
+            {
+                out.after[diffPos[idx]] = second.after[i];
+                continue;
+            }
+            out.nodes.push_back(idx);
+            out.before.push_back(second.before[i]);
+            out.after.push_back(second.after[i]);
+        }
+        for (uint32_t idx : first.nodes)
+            diffPos[idx] = NOT_IN_DIFF;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < out.nodes.size(); ++i)
+        {
+            if (out.before[i] == out.after[i])
+                continue;
+            out.nodes[kept] = out.nodes[i];
+            out.before[kept] = out.before[i];
+            out.after[kept] = out.after[i];
+            kept++;
         }
+        out.nodes.resize(kept);
+        out.before.resize(kept);
+        out.after.resize(kept);
+    }
+
+    // Puts the changes of diff in front of pending, pending then starts from where diff started
+    void prependToPending(const StateDiff &diff)
+    {
+        for (size_t i = 0; i < pending.nodes.size(); ++i)
+            diffPos[pending.nodes[i]] = i;
+        for (size_t i = 0; i < diff.nodes.size(); ++i)
+        {
+            uint32_t idx = diff.nodes[i];
+            if (inPending[idx])
+            {
+                pending.before[diffPos[idx]] = diff.before[i];
+                continue;
+            }
+            inPending[idx] = 1;
+            pending.nodes.push_back(idx);
+            pending.before.push_back(diff.before[i]);
+        }
+        for (uint32_t idx : pending.nodes)
+            diffPos[idx] = NOT_IN_DIFF;
+    }
+
+    // Doubles the steps between checkpoints, checkpoint i becomes the changes of checkpoints 2i - 1 and 2i
+    void halveCheckpoints()
+    {
+        size_t numCheckpoints = checkpoints.size();
+        for (size_t i = 1; 2 * i < numCheckpoints; ++i)
+        {
+            StateDiff merged;
+            mergeDiffs(checkpoints[2 * i - 1], checkpoints[2 * i], merged);
+            checkpoints[i].nodes.swap(merged.nodes);
+            checkpoints[i].before.swap(merged.before);
+            checkpoints[i].after.swap(merged.after);
+        }
+
+        // A last checkpoint that isn't on the new interval is now part of the way to the last step
+        if (numCheckpoints % 2 == 0)
+            prependToPending(checkpoints[numCheckpoints - 1]);
+        checkpoints.resize((numCheckpoints + 1) / 2);
+        checkpointInterval *= 2;
+
+        checkpointBytes = 0;
+        for (const StateDiff &diff : checkpoints)
+            checkpointBytes += diff.bytes();
+    }
+
+    // Saves the changes since the last checkpoint if a newly ran step falls on a checkpoint
+    void saveCheckpoint(const size_t &step)
+    {
+        if (step % checkpointInterval)
+            return;
+
+        StateDiff diff;
+        for (size_t i = 0; i < pending.nodes.size(); ++i)
+        {
+            uint32_t idx = pending.nodes[i];
+            inPending[idx] = 0;
+            if (pending.before[i] == nodeStates[idx])
+                continue;
+            diff.nodes.push_back(idx);
+            diff.before.push_back(pending.before[i]);
+            diff.after.push_back(nodeStates[idx]);
+        }
+        pending = StateDiff();
+        checkpointBytes += diff.bytes();
+        checkpoints.push_back(diff);
+
+        // Keep fewer checkpoints than steps between them, and within the memory budget while merging can still shrink them
+        while (checkpoints.size() > checkpointInterval || (checkpointBytes > ANIM_CHECKPOINT_MAX_BYTES && checkpoints.size() > 2))
+            halveCheckpoints();
+    }
+
+    // Marks the find node as found at the current step
+    inline void setFoundStep()
+    {
+        foundStep = currStep;
+    }
+
+    virtual void runStep() = 0; // Runs the algorithm one step further at currStep, saving the step's nodes and description
+
+    // Sizes the result arrays to the graph's link store with every node unreached
+    void resetResult()
+    {
+        assert(csr);
+        result.dist.assign(csr->numNodes(), -1);
+        result.parent.assign(csr->numNodes(), NULL);
+        result.visitOrder.clear();
+        result.found = false;
     }
 
     void printStepInfo(const VisNodesVec vecType, const size_t &step)
     {
-        std::vector<Node *> nodes;
-        std::string vecTypeName = "";
+        const std::string vecTypeNames[] = {"C", "R", "V", "B"};
+        size_t total = 0;
+
+        std::cout << vecTypeNames[(int)vecType] << " vecs: " << vecSteps[(int)vecType];
+        std::cout << "\tAt step: " << step << " | " << vecTypeNames[(int)vecType] << " Nodes are: ";
 
-        switch (vecType)
+        for (uint32_t e = stepLog.stepBegin(step); e < stepLog.stepEnd(step); ++e)
         {
-        case VisNodesVec::current:
-            assert(currNodes.size() > step);
-            nodes = currNodes[step];
-            vecTypeName = "C";
-            std::cout << "C vecs: " << currNodes.size();
-            break;
-        case VisNodesVec::reachable:
-            assert(reachableNodes.size() >= step);
-            nodes = reachableNodes[step];
-            vecTypeName = "R";
-            std::cout << "R vecs: " << reachableNodes.size();
-            break;
-        case VisNodesVec::visited:
-            assert(visitedNodes.size() >= step);
-            nodes = visitedNodes[step];
-            vecTypeName = "V";
-            std::cout << "V vecs: " << visitedNodes.size();
-            break;
+            if (stepLog.state(e) == vecType)
+            {
+                std::cout << "\t" << csr->nodes[stepLog.node(e)]->getNodeIdent();
+                total++;
+            }
         }
+        std::cout << "\t| total: " << total << std::endl;
+    }
 
-        std::cout << "\tAt step: " << step << " | " << vecTypeName << " Nodes are: ";
+    // Extra message engines add to a step's description, only called when the description is formatted
+    virtual std::string getStepMessage(const size_t &step) const
+    {
+        return "";
+    }
 
-        for (Node *n : nodes)
+    // Runs the next step and sets the node states for it, colors aren't applied
+    void runNextStep()
+    {
+        incCurrStep();
+        runStep();
+        recordPending = true;
+        colorStep(currStep);
+        recordPending = false;
+        saveCheckpoint(currStep);
+    }
+
+    // Sets the node states as they were at a step that has already been ran, colors aren't applied
+    // Unless step is a short way forward, replays up to the next checkpoint (or the last step ran),
+    // moves through the checkpoints to the closest one at or before step and replays the steps after it
+    void moveToStep(const size_t &step)
+    {
+        assert(step < allSteps);
+        if (step == currStep)
+            return;
+
+        size_t from = currStep;
+        if (step < currStep || step - currStep > checkpointInterval)
         {
-            assert(n);
-            std::cout << "\t" << n->getNodeIdent();
+            size_t lastRan = allSteps - 1;
+            size_t next = (currStep + checkpointInterval - 1) / checkpointInterval;
+            size_t anchor = next < checkpoints.size() ? next * checkpointInterval : lastRan;
+            for (size_t s = currStep + 1; s <= anchor; ++s)
+                colorStep(s);
+
+            size_t checkpoint = next;
+            if (next >= checkpoints.size())
+            {
+                applyDiff(pending, false);
+                checkpoint = checkpoints.size() - 1;
+            }
+
+            size_t target = step / checkpointInterval;
+            for (; checkpoint > target; --checkpoint)
+                applyDiff(checkpoints[checkpoint], false);
+            while (checkpoint < target)
+                applyDiff(checkpoints[++checkpoint], true);
+            from = target * checkpointInterval;
         }
-        std::cout << "\t| total: " << nodes.size() << std::endl;
+
+        for (size_t s = from + 1; s <= step; ++s)
+            colorStep(s);
+        currStep = step;
     }
 
 public:
@@ -207,15 +522,143 @@ public:
         allSteps = 1; // When algo starts step 0 should already be initialized with setStartNodes()
         currAlgo = AlgoToRun::NoAlgo;
         algoFinished = false;
+        csr = NULL;
+        recordPending = false;
+        checkpointBytes = 0;
+        checkpointInterval = ANIM_MIN_CHECKPOINT_INTERVAL;
+        foundStep = SIZE_MAX;
+        logSteps = true;
 
         // On first step no nodes are marked as reachable or visited
-        currNodes.push_back(std::vector<Node *>());
-        reachableNodes.push_back(std::vector<Node *>());
-        visitedNodes.push_back(std::vector<Node *>());
+        vecSteps[(int)VisNodesVec::current] = 1;
+        vecSteps[(int)VisNodesVec::reachable] = 1;
+        vecSteps[(int)VisNodesVec::visited] = 1;
+        vecSteps[(int)VisNodesVec::visitedBack] = 1;
+    }
+
+    // Sets the graph's link store to traverse, must be called before setStartNodes and stay valid while the algo runs
+    void setGraphCSR(const GraphCSR *graphCSR)
+    {
+        csr = graphCSR;
     }
 
     virtual void setStartNodes(const std::vector<Node *> &nodes) = 0; // Nodes that the algorithm starts knowing (step 0) - derived objects will save these accordingly
-    virtual void stepForward() = 0;                                   // Stepping forward; passed in nodes is current nodes to run the algo on
+
+    // Stepping forward, steps that were already ran are replayed instead of ran again
+    void stepForward()
+    {
+        if (checkpoints.empty())
+            initCheckpoints();
+
+        if (currStep + 1 < allSteps)
+            moveToStep(currStep + 1);
+        else if (!algoFinished)
+            runNextStep();
+        applyNodeStates();
+    }
+
+    // Steps forward up to maxSteps times, stopping early once budgetMs has been spent
+    // Node colors are only applied for the last step, returns the number of steps taken
+    size_t stepForwardFor(const size_t &maxSteps, const double &budgetMs)
+    {
+        if (checkpoints.empty())
+            initCheckpoints();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t startStep = currStep;
+        bool wasLogging = logSteps;
+        logSteps = maxSteps <= 1;
+
+        // Steps that were already ran are replayed in one move
+        if (currStep + 1 < allSteps)
+            moveToStep(std::min(currStep + maxSteps, allSteps - 1));
+
+        // Check the clock every few steps, a step is far cheaper than reading it
+        while (currStep - startStep < maxSteps && !algoFinished)
+        {
+            runNextStep();
+            if ((currStep - startStep) % 16 == 0 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > budgetMs)
+                break;
+        }
+
+        logSteps = wasLogging;
+        applyNodeStates();
+        return currStep - startStep;
+    }
+
+    void stepBackward()
+    {
+        if (currStep > 0)
+            seekStep(currStep - 1);
+    }
+
+    // Shows the nodes as they were at a step that has already been ran
+    void seekStep(const size_t &step)
+    {
+        if (checkpoints.empty())
+            initCheckpoints();
+        moveToStep(step);
+        applyNodeStates();
+    }
+
+    // Whether every step has been ran and the last one is shown
+    inline bool atLastStep() const
+    {
+        return algoFinished && currStep + 1 == allSteps;
+    }
+
+    inline size_t getCurrStep() const
+    {
+        return currStep;
+    }
+
+    // Number of steps ran so far, including step 0
+    inline size_t getNumSteps() const
+    {
+        return allSteps;
+    }
+
+    // Runs the algorithm from the start nodes to the end with no coloring, step descriptions or logging
+    // Doesn't touch the step data, stepForward still starts from step 0 afterwards
+    virtual const AlgoResult &runToCompletion() = 0;
+
+    inline const AlgoResult &getResult() const
+    {
+        return result;
+    }
+
+    // Nodes on the path from the start node to target found by runToCompletion, empty if target wasn't reached
+    std::vector<Node *> getResultPath(const Node *target) const
+    {
+        std::vector<Node *> path;
+        if (!target || result.dist[target->getNodeIdx()] == -1)
+            return path;
+
+        for (Node *n = csr->nodes[target->getNodeIdx()]; n; n = result.parent[n->getNodeIdx()])
+            path.push_back(n);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Colors every node visited by runToCompletion, found is colored as found if given
+    void colorResult(Node *found)
+    {
+        for (Node *n : result.visitOrder)
+        {
+            n->setNodeFillColor(ANIM_NODE_VIS_COLOR);
+            setNodeTouched(n);
+        }
+        if (found)
+        {
+            found->setNodeFillColor(ANIM_NODE_FOUND_COLOR);
+            setNodeTouched(found);
+        }
+    }
+
+    inline bool isAlgoFinished() const
+    {
+        return algoFinished;
+    }
 
     // Reset the touched node colors
     void resetTouchedColors()
@@ -226,6 +669,9 @@ public:
             node->setNodeFillColor(NODE_FILL_COLOR);
             node->setNodeOutlineColor(NODE_OUT_COLOR); // NOTE: might be unnecessary
         }
+        std::fill(nodeStates.begin(), nodeStates.end(), 0);
+        std::fill(isDirty.begin(), isDirty.end(), 0);
+        dirtyNodes.clear();
     }
 
     // NOTE: if you are deleting the instance you might just need to reset the colors and delete this func
@@ -238,65 +684,92 @@ public:
         algoFinished = false;
         currAlgo = AlgoToRun::NoAlgo;
 
-        currNodes.erase(currNodes.begin() + 1, currNodes.end());
-        reachableNodes.erase(reachableNodes.begin() + 1, reachableNodes.end());
-        visitedNodes.erase(visitedNodes.begin() + 1, visitedNodes.end());
+        stepLog.clear();
+        vecSteps[(int)VisNodesVec::current] = 1;
+        vecSteps[(int)VisNodesVec::reachable] = 1;
+        vecSteps[(int)VisNodesVec::visited] = 1;
+        vecSteps[(int)VisNodesVec::visitedBack] = 1;
+        stepNotes.clear();
+        noteMessages.clear();
+        nodeStates.clear();
+        isDirty.clear();
+        checkpoints.clear();
+        pending = StateDiff();
+        inPending.clear();
+        diffPos.clear();
+        checkpointBytes = 0;
+        checkpointInterval = ANIM_MIN_CHECKPOINT_INTERVAL;
+        foundStep = SIZE_MAX;
     }
 
     std::string getStepString()
     {
-        if (algoFinished)
-            return AlgoNames[(int)currAlgo] + " algo has completed in " + std::to_string(allSteps) + " steps";
         if (currStep < allSteps - 1)
-            return "On Step: " + std::to_string(currStep + 1) + "/" + std::to_string(allSteps + 1);
+            return "On Step: " + std::to_string(currStep) + "/" + std::to_string(allSteps - 1);
+        if (algoFinished)
+            return AlgoNames[(int)currAlgo] + " algo has completed in " + std::to_string(allSteps - 1) + " steps";
         return "Curr Step: " + std::to_string(currStep);
     }
 
-    void addStepDescription(const size_t &step, Node *curr, const Node *find, bool failed, std::string additionalMessage = "")
+    void addStepDescription(const size_t &step, Node *curr, const Node *find, bool failed, const std::string &additionalMessage = "")
     {
         assert(step >= 0);
+        StepNote note;
+        note.step = step;
+        note.curr = curr ? curr->getNodeIdx() : StepNote::NO_NODE;
+        note.find = find ? find->getNodeIdx() : StepNote::NO_NODE;
+        note.failed = failed;
+        note.listsReachable = step < vecSteps[(int)VisNodesVec::reachable];
+        note.messageBegin = noteMessages.size();
+        noteMessages += additionalMessage;
+        note.messageEnd = noteMessages.size();
+        stepNotes.push_back(note);
+    }
+
+    inline size_t getNumStepDescriptions() const
+    {
+        return stepNotes.size();
+    }
+
+    // Formats the i-th step description
+    std::string getStepDescription(const size_t &i) const
+    {
+        assert(i < stepNotes.size());
+        const StepNote &note = stepNotes[i];
         std::stringstream ss;
-        std::string start = (!curr) ? "-" : std::to_string(curr->getNodeIdent());
-        ss << "Step " << step << "\n\tOn node: " << start;
+        std::string start = (note.curr == StepNote::NO_NODE) ? "-" : std::to_string(csr->nodes[note.curr]->getNodeIdent());
+        ss << "Step " << note.step << "\n\tOn node: " << start;
 
-        if (step < reachableNodes.size())
+        if (note.listsReachable)
         {
-            if (reachableNodes[step].size() > 0)
-                ss << "\n\tCan reach: ";
-            else
-                ss << "\n\tNo reachable nodes\n";
-
-            for (size_t i = 0; i < reachableNodes[step].size(); ++i)
+            bool first = true;
+            for (uint32_t e = stepLog.stepBegin(note.step); e < stepLog.stepEnd(note.step); ++e)
             {
-                ss << reachableNodes[step][i]->getNodeIdent();
-                if (i != reachableNodes[step].size() - 1)
-                    ss << ", ";
-                else
-                    ss << "\n";
+                if (stepLog.state(e) != VisNodesVec::reachable)
+                    continue;
+                ss << (first ? "\n\tCan reach: " : ", ") << csr->nodes[stepLog.node(e)]->getNodeIdent();
+                first = false;
             }
+            ss << (first ? "\n\tNo reachable nodes\n" : "\n");
         }
 
+        std::string additionalMessage = noteMessages.substr(note.messageBegin, note.messageEnd - note.messageBegin) + getStepMessage(note.step);
         if (additionalMessage != "")
             ss << "\t" << additionalMessage << "\n";
 
-        if (find)
+        if (note.find != StepNote::NO_NODE)
         {
-            if (failed)
+            if (note.failed)
             {
-                ss << "\t" << "Failed to find node " << find->getNodeIdent();
+                ss << "\t" << "Failed to find node " << csr->nodes[note.find]->getNodeIdent();
             }
             else
             {
-                ss << "\t" << "Found node " << find->getNodeIdent() << " @ step: " << step;
+                ss << "\t" << "Found node " << csr->nodes[note.find]->getNodeIdent() << " @ step: " << note.step;
             }
         }
 
-        stepDescription.push_back(ss.str());
-    }
-
-    const std::vector<std::string> &getStepDescriptions() const
-    {
-        return stepDescription;
+        return ss.str();
     }
 
     void addToDijkTable(const ll &childId, const CHILD_WEIGHT &weight)
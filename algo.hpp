@@ -7,10 +7,19 @@ algo.hpp
 #include "DFSImpl.hpp"
 #include "BFSImpl.hpp"
 #include "DijkImpl.hpp"
+#include "BiDijkImpl.hpp"
+#include "AStarImpl.hpp"
+#include "landmarks.hpp"
+#include "CHImpl.hpp"
+
+#define ALGO_PLAY_DEFAULT_STEPS_PER_SEC 10.f
+#define ALGO_PLAY_MIN_STEPS_PER_SEC 1.f
+#define ALGO_PLAY_MAX_STEPS_PER_SEC 100000.f
+#define ALGO_PLAY_FRAME_BUDGET_MS 8.0 // Time a frame can spend stepping while playing, leaves the rest of a 60 fps frame to drawing
 
 // List of possible algos the user can run
-static const std::string algo_list[] = {"Graph DFS", "Graph BFS", "Dijkstra"};
-static const std::string algo_init_menu[] = {"DFS Menu", "BFS Menu", "Dijkstra Menu"};
+static const std::string algo_list[] = {"Graph DFS", "Graph BFS", "Dijkstra", "Bidirectional Dijkstra", "A*", "Contraction Hierarchy"};
+static const std::string algo_init_menu[] = {"DFS Menu", "BFS Menu", "Dijkstra Menu", "Bidirectional Dijkstra Menu", "A* Menu", "Contraction Hierarchy Menu"};
 enum NodeSelectMode
 {
     NoSelected,
@@ -23,20 +32,34 @@ class Algos
 public:
     // map<curr node identifier, tuple<distance from node to curr node, from node identifier>>
     typedef std::unordered_map<ll, std::tuple<long long, ll>> weight_map;
-    // typedef for node links
-    typedef std::tuple<Node *, ll, ll, bool> ADJ_NODE;
 
     Node *startN;
     Node *findN;
     AlgoToRun runAlgo;
     NodeSelectMode selectMode;
     IAnimImpl *algoAnim;
+    Graph *graph;                 // Graph the algorithms run on
+    DijkQueueType dijkQueueType; // Priority queue Dijkstra runs with
+    bool dijkParallel;           // Whether Dijkstra runs to completion with delta-stepping on every core
+    bool bfsParallel;            // Whether BFS runs to completion with direction optimizing BFS on every core
+    std::unique_ptr<WorkStealingPool> pool; // Workers for parallel runs, started the first time one is asked for
+    Landmarks landmarks;          // Landmark distances for A*, recomputed in the background after the graph changes
+    bool aStarLandmarks;          // Whether A* estimates with the landmarks instead of canvas distance
+    Hierarchy hierarchy;          // Contracted graph for CH queries, contracted again in the background after the graph changes
 
     // Node selection start menu options
     bool startSelectPressed;
     bool findSelectPressed;
     bool algoRunning;
+    bool stepsShown; // Whether the step panel is open, false while showing a run to completion result
     std::string runningAlgoName;
+    std::string stepText;  // Formatted step descriptions shown in the step panel
+    size_t describedSteps; // Number of step descriptions in stepText
+    AlgoAnimationMode playMode;
+    float stepsPerSecond; // Steps played a second while playing
+    double stepDebt;      // Steps owed from previous frames, played once they add up to a whole step
+    char startIDInput[32]; // Start node identifier typed into the start menu
+    char findIDInput[32];  // Find node identifier typed into the start menu
 
 public:
     Algos()
@@ -45,6 +68,11 @@ public:
         runAlgo = NoAlgo;
         selectMode = NoSelected;
         algoAnim = NULL;
+        graph = NULL;
+        dijkQueueType = DijkQueueType::Auto;
+        dijkParallel = false;
+        bfsParallel = false;
+        aStarLandmarks = false;
 
         // Stores the nodes to run the algo on
         startN = NULL;
@@ -53,7 +81,21 @@ public:
         startSelectPressed = false;
         findSelectPressed = false;
         algoRunning = false;
+        stepsShown = false;
         runningAlgoName = "";
+        stepText = "";
+        describedSteps = 0;
+        playMode = AlgoAnimationMode::Pause;
+        stepsPerSecond = ALGO_PLAY_DEFAULT_STEPS_PER_SEC;
+        stepDebt = 0;
+        memset(startIDInput, '\0', sizeof(startIDInput));
+        memset(findIDInput, '\0', sizeof(findIDInput));
+    }
+
+    // Sets the graph the algorithms will run on
+    void setGraph(Graph *g)
+    {
+        graph = g;
     }
 
     // Display list of algos in menu the the user can select to run
@@ -63,7 +105,7 @@ public:
         {
             if (ImGui::Button(algo.c_str()))
             {
-                if (algo_list[(int)runAlgo] == algo)
+                if (runAlgo != AlgoToRun::NoAlgo && algo_list[(int)runAlgo] == algo)
                 {
                     std::cout << "Algo " << algo << " toggled off" << std::endl;
                     runAlgo = NoAlgo;
@@ -86,6 +128,21 @@ public:
                         runAlgo = Dijkstra;
                         algoAnim = new DijkImpl();
                     }
+                    else if (algo == algo_list[3])
+                    {
+                        runAlgo = BiDijkstra;
+                        algoAnim = new BiDijkImpl();
+                    }
+                    else if (algo == algo_list[4])
+                    {
+                        runAlgo = AStar;
+                        algoAnim = new AStarImpl();
+                    }
+                    else if (algo == algo_list[5])
+                    {
+                        runAlgo = CH;
+                        algoAnim = new CHImpl();
+                    }
                     guiRunAlgo = runAlgo;
                     std::cout << "Clicked on button: " << algo << std::endl;
                 }
@@ -132,8 +189,8 @@ public:
             }
         }
 
-        // Find node only matters for BFS/DFS
-        if (runAlgo < AlgoToRun::Dijkstra)
+        // Dijkstra's full search from the start is the only algo without a find node
+        if (runAlgo != AlgoToRun::Dijkstra)
         {
             findButtonName = findSelectPressed ? "X###2" : "O###2";
             if (ImGui::Button(findButtonName.c_str(), ImVec2(20, 20)))
@@ -169,24 +226,82 @@ public:
         }
         ImGui::EndGroup();
 
+        // Select start/find nodes by typing their identifier
+        if (ImGui::InputText("Start node ID", startIDInput, sizeof(startIDInput), ImGuiInputTextFlags_EnterReturnsTrue))
+            selectNodeByID(startIDInput, startN);
+        if (runAlgo != AlgoToRun::Dijkstra)
+        {
+            if (ImGui::InputText("Find node ID", findIDInput, sizeof(findIDInput), ImGuiInputTextFlags_EnterReturnsTrue))
+                selectNodeByID(findIDInput, findN);
+        }
+
+        // Dijkstra's priority queue selection, auto picks by the graph's max link weight
+        if (runAlgo == AlgoToRun::Dijkstra || runAlgo == AlgoToRun::BiDijkstra)
+        {
+            ImGui::Text("Priority queue:");
+            for (int i = 0; i <= (int)DijkQueueType::Dial; ++i)
+            {
+                if (i > 0)
+                    ImGui::SameLine();
+                if (ImGui::RadioButton(DijkQueueNames[i].c_str(), dijkQueueType == (DijkQueueType)i))
+                    dijkQueueType = (DijkQueueType)i;
+            }
+            if (runAlgo == AlgoToRun::Dijkstra)
+                ImGui::Checkbox("Run to completion in parallel (delta-stepping)", &dijkParallel);
+        }
+
+        // BFS only runs on every core once it runs to completion, steps go through the queue
+        if (runAlgo == AlgoToRun::BFS)
+            ImGui::Checkbox("Run to completion in parallel (direction optimizing)", &bfsParallel);
+
+        // A*'s estimate, landmarks fall back to plain Dijkstra while they are being recomputed
+        if (runAlgo == AlgoToRun::AStar)
+        {
+            ImGui::Text("Estimate:");
+            if (ImGui::RadioButton("Canvas distance", !aStarLandmarks))
+                aStarLandmarks = false;
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Landmarks", aStarLandmarks))
+                aStarLandmarks = true;
+            if (aStarLandmarks)
+            {
+                std::shared_ptr<const LandmarkTable> table = landmarks.get(*graph);
+                if (table)
+                    ImGui::Text("%zu landmarks ready", table->landmarks.size());
+                else
+                    ImGui::Text(landmarks.isComputing() ? "Computing landmarks, runs as Dijkstra" : "Landmarks stale, runs as Dijkstra");
+            }
+        }
+
+        // Contraction only happens once for an unchanged graph, CH can't run until the hierarchy matches the graph
+        std::shared_ptr<const ContractionHierarchy> ch = runAlgo == AlgoToRun::CH ? hierarchy.get(*graph) : NULL;
+        if (runAlgo == AlgoToRun::CH)
+        {
+            if (ch)
+                ImGui::Text("Hierarchy ready, %zu shortcuts, contracted in %.1f ms", ch->numShortcuts, ch->buildMs);
+            else
+                ImGui::Text(hierarchy.isComputing() ? "Contracting..." : "Waiting for edits to settle before contracting");
+        }
+
         // Create run algo button if algo nodes selected
-        if (startN && (findN || runAlgo == AlgoToRun::Dijkstra))
+        if (startN && (findN || runAlgo == AlgoToRun::Dijkstra) && (ch || runAlgo != AlgoToRun::CH))
         {
             std::string runAlgoMessage = "Run " + algo_list[(int)runAlgo] + " algorithm";
             if (ImGui::Button(runAlgoMessage.c_str(), ImVec2(250, 25)))
             {
                 std::cout << runAlgoMessage + " clicked\n";
-                algoRunning = true;
-                runningAlgoName = "Step Descriptions for " + algo_list[(int)runAlgo];
-
-                std::vector<Node *> startNodes{startN};
+                startAlgo();
+                stepsShown = true;
+            }
 
-                if (runAlgo != AlgoToRun::Dijkstra)
-                {
-                    // BFS/DFS both need start and find nodes
-                    startNodes.push_back(findN);
-                }
-                algoAnim->setStartNodes(startNodes);
+            // Runs the whole algorithm at once, the step panel is only built if the user asks for it
+            if (ImGui::Button("Run to completion", ImVec2(250, 25)))
+            {
+                std::cout << "Run " + algo_list[(int)runAlgo] + " to completion clicked\n";
+                startAlgo();
+                const AlgoResult &result = algoAnim->runToCompletion();
+                algoAnim->colorResult(result.found ? findN : NULL);
+                stepsShown = false;
             }
         }
 
@@ -210,6 +325,88 @@ public:
         ImGui::End();
     }
 
+    // Hands the selected nodes and the graph's link store to the algo
+    void startAlgo()
+    {
+        algoRunning = true;
+        runningAlgoName = "Step Descriptions for " + algo_list[(int)runAlgo];
+
+        std::vector<Node *> startNodes{startN};
+        assert(graph);
+
+        if (runAlgo != AlgoToRun::Dijkstra)
+        {
+            // BFS/DFS, bidirectional Dijkstra, A* and CH need start and find nodes
+            startNodes.push_back(findN);
+        }
+
+        if (runAlgo == AlgoToRun::Dijkstra)
+        {
+            static_cast<DijkImpl *>(algoAnim)->setQueueType(dijkQueueType, graph->getMaxLinkWeight());
+            static_cast<DijkImpl *>(algoAnim)->setParallel(dijkParallel ? getPool() : NULL);
+        }
+        else if (runAlgo == AlgoToRun::BFS)
+            static_cast<BFSImpl *>(algoAnim)->setParallel(bfsParallel ? getPool() : NULL);
+        else if (runAlgo == AlgoToRun::BiDijkstra)
+            static_cast<BiDijkImpl *>(algoAnim)->setQueueType(dijkQueueType, graph->getMaxLinkWeight());
+        else if (runAlgo == AlgoToRun::AStar)
+            static_cast<AStarImpl *>(algoAnim)->setHeuristic(makeAStarHeuristic());
+        else if (runAlgo == AlgoToRun::CH)
+            static_cast<CHImpl *>(algoAnim)->setHierarchy(hierarchy.get(*graph));
+
+        // Algorithms run on the graph's link store directly, graph can't change while algo runs
+        algoAnim->setGraphCSR(&graph->buildCSR());
+        algoAnim->setStartNodes(startNodes);
+    }
+
+    // Estimate A* runs with, plain Dijkstra if landmarks were picked but are stale
+    IHeuristic *makeAStarHeuristic()
+    {
+        if (!aStarLandmarks)
+            return new EuclideanHeuristic(graph->getMinWeightPerPixel());
+
+        std::shared_ptr<const LandmarkTable> table = landmarks.get(*graph);
+        if (table)
+            return new LandmarkHeuristic(table);
+        std::cout << "Landmarks are stale, A* runs as Dijkstra\n";
+        return new ZeroHeuristic();
+    }
+
+    // Pool with a worker for every core, started on first use
+    WorkStealingPool *getPool()
+    {
+        if (!pool)
+        {
+            pool.reset(new WorkStealingPool());
+            std::cout << "Started " << pool->numWorkers() << " workers\n";
+        }
+        return pool.get();
+    }
+
+    // Keeps the landmarks up to date with the graph while A* with landmarks is picked, called every frame
+    void updateLandmarks()
+    {
+        assert(graph);
+        if (runAlgo == AlgoToRun::AStar && aStarLandmarks)
+            landmarks.update(*graph);
+    }
+
+    // Keeps the hierarchy up to date with the graph while CH is picked, called every frame
+    void updateHierarchy()
+    {
+        assert(graph);
+        if (runAlgo == AlgoToRun::CH)
+            hierarchy.update(*graph);
+    }
+
+    // Opens the step panel after a run to completion, steps are built from step 0 as the user steps forward
+    void showAlgoSteps()
+    {
+        assert(algoAnim);
+        algoAnim->resetTouchedColors();
+        stepsShown = true;
+    }
+
     // Helper to allow node to be selected as either start/find node for algorithm
     // Should only be called if start menu is open
     void setSelectedAlgoNode(Node *selected)
@@ -244,7 +441,12 @@ public:
         startSelectPressed = false;
         findSelectPressed = false;
         algoRunning = false;
+        stepsShown = false;
         runningAlgoName = "";
+        stepText = "";
+        describedSteps = 0;
+        playMode = AlgoAnimationMode::Pause;
+        stepDebt = 0;
     }
 
     bool checkPossibleID(char *id, int len)
@@ -257,16 +459,106 @@ public:
         return true;
     }
 
+    // Saves the node with the typed identifier into selected, clears the input
+    // selected is left unchanged if the identifier isn't a number or the node doesn't exist
+    void selectNodeByID(char *id, Node *&selected)
+    {
+        assert(graph);
+        int len = strlen(id);
+        if (len > 0 && len < 19 && checkPossibleID(id, len))
+        {
+            Node *n = graph->findNode(std::stoll(id));
+            if (n)
+            {
+                selected = n;
+                std::cout << "Saved Node: " << n->getNodeIdent() << " by ID\n";
+            }
+            else
+            {
+                std::cout << "Node " << id << " doesn't exist\n";
+            }
+        }
+        memset(id, '\0', len);
+    }
+
     void algoStepForward()
     {
         assert(algoAnim);
         algoAnim->stepForward();
     }
 
-    const std::vector<std::string> &algoGetStepDescription()
+    void algoStepBackward()
+    {
+        assert(algoAnim);
+        algoAnim->stepBackward();
+    }
+
+    // Jumps to a step that has already been ran
+    void algoSeekStep(const size_t &step)
+    {
+        assert(algoAnim);
+        algoAnim->seekStep(step);
+    }
+
+    // Starts playing from the current step, starts over if the last step is shown
+    void algoPlay()
+    {
+        assert(algoAnim);
+        if (algoAnim->atLastStep())
+            algoAnim->seekStep(0);
+        playMode = AlgoAnimationMode::Play;
+        stepDebt = 0;
+    }
+
+    void algoPause()
+    {
+        playMode = AlgoAnimationMode::Pause;
+        stepDebt = 0;
+    }
+
+    // Plays the steps owed for the time passed since the last frame, called every frame
+    // Steps past the frame budget are dropped so playback slows down instead of the frame rate
+    void algoUpdatePlay(float dt)
+    {
+        assert(algoAnim);
+        if (playMode != AlgoAnimationMode::Play)
+            return;
+
+        stepDebt += stepsPerSecond * dt;
+        size_t steps = (size_t)stepDebt;
+        if (steps == 0)
+            return;
+
+        size_t taken = algoAnim->stepForwardFor(steps, ALGO_PLAY_FRAME_BUDGET_MS);
+        stepDebt = taken == steps ? stepDebt - steps : 0;
+
+        if (algoAnim->atLastStep())
+            algoPause();
+    }
+
+    // Text of every step description so far, descriptions are formatted the first time the step panel shows them
+    const std::string &algoGetStepText()
+    {
+        assert(algoAnim);
+        for (; describedSteps < algoAnim->getNumStepDescriptions(); ++describedSteps)
+        {
+            if (describedSteps > 0)
+                stepText += "\n";
+            stepText += algoAnim->getStepDescription(describedSteps);
+        }
+        return stepText;
+    }
+
+    const AlgoResult &algoGetResult()
+    {
+        assert(algoAnim);
+        return algoAnim->getResult();
+    }
+
+    std::vector<Node *> algoGetResultPath()
     {
         assert(algoAnim);
-        return algoAnim->getStepDescriptions();
+        return algoAnim->getResultPath(findN);
     }
 
     const std::map<ll, CHILD_WEIGHT> &algoGetDijkTable()
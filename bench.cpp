@@ -0,0 +1,563 @@
+/*
+bench.cpp
+    - Headless benchmark of the graph structure and traversal engines (no imgui, no window)
+    - Generates grid, Erdos-Renyi, random geometric and R-MAT graphs and prints timings as CSV
+    - usage: dijk_bench [--max-edges N] [--gen grid|er|geo|rmat] [--seed S] [--threads T]
+ */
+#define DIJK_HEADLESS
+#define _USE_MATH_DEFINES
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "DFSImpl.hpp"
+#include "BFSImpl.hpp"
+#include "DijkImpl.hpp"
+#include "BiDijkImpl.hpp"
+#include "AStarImpl.hpp"
+#include "landmarks.hpp"
+#include "CHImpl.hpp"
+
+#define BENCH_FRAME_BUDGET_MS 8.0 // Stepping budget of a played frame, same as the gui's
+
+/*
+    Allocation counting
+*/
+
+static std::atomic<size_t> allocCount(0);
+
+void *operator new(size_t size)
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// Peak resident set size of the process in KB
+size_t peakRSSKB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize / 1024;
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+/*
+    Synthetic graphs
+*/
+
+typedef std::pair<uint32_t, uint32_t> EDGE;
+
+struct SynthGraph
+{
+    std::string name;
+    uint32_t numNodes;
+    std::vector<EDGE> edges;
+    std::vector<sf::Vector2i> pos; // <node, position> plus one extra isolated node used as the BFS/DFS find node
+    int canvas;                    // Width and height of the simul area holding every position
+};
+
+// Keeps edges unique and drops self loops
+class EdgeSet
+{
+private:
+    std::unordered_set<uint64_t> seen;
+
+public:
+    bool add(uint32_t u, uint32_t v, std::vector<EDGE> &edges)
+    {
+        if (u == v)
+            return false;
+        uint64_t key = u < v ? ((uint64_t)u << 32) | v : ((uint64_t)v << 32) | u;
+        if (!seen.insert(key).second)
+            return false;
+        edges.push_back(EDGE(u, v));
+        return true;
+    }
+};
+
+// Places node i on a square lattice one pixel apart (node circles overlap, only unique positions matter here)
+void placeOnLattice(SynthGraph &g)
+{
+    uint32_t count = g.numNodes + 1;
+    int side = (int)std::ceil(std::sqrt((double)count));
+    g.canvas = side + 2 * NODE_RADIUS + 1;
+    g.pos.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+        g.pos[i] = sf::Vector2i(NODE_RADIUS + i % side, NODE_RADIUS + i / side);
+}
+
+SynthGraph makeGrid(size_t targetEdges)
+{
+    SynthGraph g;
+    int side = std::max(2, (int)std::ceil(std::sqrt(targetEdges / 2.0)));
+    g.name = "grid";
+    g.numNodes = side * side;
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            uint32_t u = y * side + x;
+            if (x + 1 < side)
+                g.edges.push_back(EDGE(u, u + 1));
+            if (y + 1 < side)
+                g.edges.push_back(EDGE(u, u + side));
+        }
+    }
+
+    // keep the lattice layout of the grid itself
+    g.canvas = side + 2 * NODE_RADIUS + 2;
+    for (uint32_t i = 0; i < g.numNodes; ++i)
+        g.pos.push_back(sf::Vector2i(NODE_RADIUS + i % side, NODE_RADIUS + i / side));
+    g.pos.push_back(sf::Vector2i(NODE_RADIUS, NODE_RADIUS + side));
+    return g;
+}
+
+// Erdos-Renyi G(n, m) with an average degree of 8
+SynthGraph makeErdosRenyi(size_t targetEdges, std::mt19937 &rng)
+{
+    SynthGraph g;
+    g.name = "erdos_renyi";
+    g.numNodes = std::max<size_t>(targetEdges / 4, 8);
+    EdgeSet set;
+    std::uniform_int_distribution<uint32_t> pick(0, g.numNodes - 1);
+    while (g.edges.size() < targetEdges)
+        set.add(pick(rng), pick(rng), g.edges);
+    placeOnLattice(g);
+    return g;
+}
+
+// Random geometric graph in the unit square with an expected average degree of 8
+SynthGraph makeGeometric(size_t targetEdges, std::mt19937 &rng)
+{
+    SynthGraph g;
+    g.name = "geometric";
+    g.numNodes = std::max<size_t>(targetEdges / 4, 8);
+    uint32_t n = g.numNodes;
+    double radius = std::sqrt(8.0 / (M_PI * n));
+
+    std::uniform_real_distribution<double> coord(0.0, 1.0);
+    std::vector<double> xs(n), ys(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        xs[i] = coord(rng);
+        ys[i] = coord(rng);
+    }
+
+    // bucket points into radius sized cells so only neighbouring cells are compared
+    int cells = std::max(1, (int)(1.0 / radius));
+    std::vector<std::vector<uint32_t>> buckets((size_t)cells * cells);
+    for (uint32_t i = 0; i < n; ++i)
+        buckets[std::min(cells - 1, (int)(ys[i] * cells)) * cells + std::min(cells - 1, (int)(xs[i] * cells))].push_back(i);
+
+    for (int cy = 0; cy < cells; ++cy)
+    {
+        for (int cx = 0; cx < cells; ++cx)
+        {
+            for (uint32_t u : buckets[cy * cells + cx])
+            {
+                for (int ny = std::max(0, cy - 1); ny <= std::min(cells - 1, cy + 1); ++ny)
+                {
+                    for (int nx = std::max(0, cx - 1); nx <= std::min(cells - 1, cx + 1); ++nx)
+                    {
+                        for (uint32_t v : buckets[ny * cells + nx])
+                        {
+                            double dx = xs[u] - xs[v], dy = ys[u] - ys[v];
+                            if (u < v && dx * dx + dy * dy <= radius * radius)
+                                g.edges.push_back(EDGE(u, v));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // scale points onto a pixel lattice, probing forward when two points land on the same pixel
+    int side = 2 * (int)std::ceil(std::sqrt((double)n + 1));
+    g.canvas = side + 2 * NODE_RADIUS + 1;
+    std::vector<uint8_t> taken((size_t)side * side, 0);
+    for (uint32_t i = 0; i <= n; ++i)
+    {
+        size_t cell = i < n ? (size_t)(ys[i] * side) * side + (size_t)(xs[i] * side) : 0;
+        while (taken[cell])
+            cell = (cell + 1) % taken.size();
+        taken[cell] = 1;
+        g.pos.push_back(sf::Vector2i(NODE_RADIUS + cell % side, NODE_RADIUS + cell / side));
+    }
+    return g;
+}
+
+// R-MAT (a, b, c, d) = (0.57, 0.19, 0.19, 0.05) with an average degree of 16
+SynthGraph makeRMAT(size_t targetEdges, std::mt19937 &rng)
+{
+    SynthGraph g;
+    g.name = "rmat";
+    int scale = 3;
+    while (((size_t)1 << scale) < targetEdges / 8)
+        scale++;
+    g.numNodes = 1u << scale;
+
+    EdgeSet set;
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    size_t attempts = 0;
+    while (g.edges.size() < targetEdges && attempts++ < targetEdges * 8)
+    {
+        uint32_t u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit)
+        {
+            double r = coin(rng);
+            if (r < 0.57)
+                continue;
+            else if (r < 0.76)
+                v |= 1u << bit;
+            else if (r < 0.95)
+                u |= 1u << bit;
+            else
+            {
+                u |= 1u << bit;
+                v |= 1u << bit;
+            }
+        }
+        set.add(u, v, g.edges);
+    }
+    placeOnLattice(g);
+    return g;
+}
+
+/*
+    Measurements
+*/
+
+class Timer
+{
+private:
+    std::chrono::steady_clock::time_point start;
+    size_t allocStart;
+
+public:
+    Timer() : start(std::chrono::steady_clock::now()), allocStart(allocCount.load()) {}
+
+    double ns() const
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    size_t allocs() const
+    {
+        return allocCount.load() - allocStart;
+    }
+};
+
+// Prints a CSV row, edges is the size of the graph the operation ran on
+void report(const SynthGraph &g, const char *op, size_t ops, const Timer &t)
+{
+    double ns = t.ns();
+    size_t allocs = t.allocs();
+    printf("%s,%u,%zu,%s,%zu,%.3f,%.1f,%.2f,%zu,%.2f\n", g.name.c_str(), g.numNodes, g.edges.size(), op, ops, ns / 1e6,
+           ops ? ns / ops : 0.0, g.edges.size() ? ns / g.edges.size() : 0.0, peakRSSKB(), ops ? (double)allocs / ops : 0.0);
+    fflush(stdout);
+}
+
+// Steps an engine until it finishes, returns the number of steps
+size_t runEngine(IAnimImpl &algo)
+{
+    size_t steps = 0;
+    while (!algo.isAlgoFinished())
+    {
+        algo.stepForward();
+        steps++;
+    }
+    return steps;
+}
+
+void benchGraph(const SynthGraph &sg, std::mt19937 &rng, WorkStealingPool &pool)
+{
+    Graph graph(sg.canvas, sg.canvas, sg.canvas, sg.canvas);
+    sf::Font font;
+    std::vector<Node *> nodes(sg.pos.size());
+
+    {
+        Timer t;
+        for (size_t i = 0; i < sg.pos.size(); ++i)
+        {
+            graph.createNewNode(sg.pos[i], font);
+            nodes[i] = graph.getNodeAtPosition(sg.pos[i]);
+        }
+        report(sg, "create", sg.pos.size(), t);
+    }
+
+    {
+        std::uniform_int_distribution<int> weight(1, 100);
+        Timer t;
+        for (const EDGE &e : sg.edges)
+            graph.joinNodes(nodes[e.first], nodes[e.second], weight(rng), LinkStat::Doubly);
+        report(sg, "join", sg.edges.size(), t);
+    }
+
+    const GraphCSR *csr;
+    {
+        Timer t;
+        csr = &graph.buildCSR();
+        report(sg, "csr_build", sg.edges.size(), t);
+    }
+
+    // the find node is isolated so BFS/DFS traverse the whole graph of the start node
+    Node *start = nodes[0];
+    Node *find = nodes.back();
+    {
+        BFSImpl bfs;
+        Timer t;
+        bfs.setGraphCSR(csr);
+        bfs.setStartNodes(std::vector<Node *>{start, find});
+        runEngine(bfs);
+        report(sg, "bfs", sg.edges.size(), t);
+    }
+    {
+        DFSImpl dfs;
+        Timer t;
+        dfs.setGraphCSR(csr);
+        dfs.setStartNodes(std::vector<Node *>{start, find});
+        runEngine(dfs);
+        report(sg, "dfs", sg.edges.size(), t);
+    }
+    {
+        DijkImpl dijk;
+        Timer t;
+        dijk.setGraphCSR(csr);
+        dijk.setQueueType(DijkQueueType::Auto, graph.getMaxLinkWeight());
+        dijk.setStartNodes(std::vector<Node *>{start});
+        runEngine(dijk);
+        report(sg, "dijkstra", sg.edges.size(), t);
+    }
+    {
+        // played the way the gui plays it, a frame's budget of steps at a time
+        DijkImpl dijk;
+        Timer t;
+        dijk.setGraphCSR(csr);
+        dijk.setQueueType(DijkQueueType::Auto, graph.getMaxLinkWeight());
+        dijk.setStartNodes(std::vector<Node *>{start});
+        size_t frames = 0;
+        while (!dijk.atLastStep())
+        {
+            dijk.stepForwardFor(SIZE_MAX, BENCH_FRAME_BUDGET_MS);
+            frames++;
+        }
+        report(sg, "dijkstra_play", frames, t);
+    }
+
+    // same traversals without building the step timeline
+    {
+        BFSImpl bfs;
+        Timer t;
+        bfs.setGraphCSR(csr);
+        bfs.setStartNodes(std::vector<Node *>{start, find});
+        bfs.runToCompletion();
+        report(sg, "bfs_run", sg.edges.size(), t);
+    }
+    {
+        BFSImpl bfs;
+        Timer t;
+        bfs.setGraphCSR(csr);
+        bfs.setParallel(&pool);
+        bfs.setStartNodes(std::vector<Node *>{start, find});
+        bfs.runToCompletion();
+        report(sg, "bfs_parallel_run", sg.edges.size(), t);
+    }
+    {
+        // reachability alone, levels without the parents and order matching the queue
+        std::vector<uint32_t> levels;
+        Timer t;
+        DirectionOptimizingBFS bfs(*csr, pool);
+        bfs.run(start->getNodeIdx(), DirectionOptimizingBFS::UNREACHED, levels);
+        report(sg, "bfs_levels", sg.edges.size(), t);
+    }
+    {
+        DFSImpl dfs;
+        Timer t;
+        dfs.setGraphCSR(csr);
+        dfs.setStartNodes(std::vector<Node *>{start, find});
+        dfs.runToCompletion();
+        report(sg, "dfs_run", sg.edges.size(), t);
+    }
+    {
+        DijkImpl dijk;
+        Timer t;
+        dijk.setGraphCSR(csr);
+        dijk.setQueueType(DijkQueueType::Auto, graph.getMaxLinkWeight());
+        dijk.setStartNodes(std::vector<Node *>{start});
+        dijk.runToCompletion();
+        report(sg, "dijkstra_run", sg.edges.size(), t);
+    }
+    {
+        DijkImpl dijk;
+        Timer t;
+        dijk.setGraphCSR(csr);
+        dijk.setQueueType(DijkQueueType::Auto, graph.getMaxLinkWeight());
+        dijk.setParallel(&pool);
+        dijk.setStartNodes(std::vector<Node *>{start});
+        dijk.runToCompletion();
+        report(sg, "dijkstra_delta_run", sg.edges.size(), t);
+    }
+    {
+        // point to point from the first to the last generated node, ops is the number of nodes settled
+        BiDijkImpl biDijk;
+        Timer t;
+        biDijk.setGraphCSR(csr);
+        biDijk.setQueueType(DijkQueueType::Auto, graph.getMaxLinkWeight());
+        biDijk.setStartNodes(std::vector<Node *>{start, nodes[sg.numNodes - 1]});
+        const AlgoResult &result = biDijk.runToCompletion();
+        report(sg, "bidijkstra_run", result.visitOrder.size(), t);
+    }
+    {
+        AStarImpl aStar;
+        Timer t;
+        aStar.setGraphCSR(csr);
+        aStar.setHeuristic(new EuclideanHeuristic(graph.getMinWeightPerPixel()));
+        aStar.setStartNodes(std::vector<Node *>{start, nodes[sg.numNodes - 1]});
+        const AlgoResult &result = aStar.runToCompletion();
+        report(sg, "astar_run", result.visitOrder.size(), t);
+    }
+    {
+        // landmarks are computed on the calling thread here, the app does the same on a background thread
+        std::shared_ptr<LandmarkTable> table = std::make_shared<LandmarkTable>();
+        Timer t;
+        computeLandmarkTable(*csr, ALT_NUM_LANDMARKS, graph.getVersion(), *table);
+        report(sg, "alt_preprocess", table->landmarks.size(), t);
+
+        AStarImpl aStar;
+        Timer tq;
+        aStar.setGraphCSR(csr);
+        aStar.setHeuristic(new LandmarkHeuristic(table));
+        aStar.setStartNodes(std::vector<Node *>{start, nodes[sg.numNodes - 1]});
+        const AlgoResult &result = aStar.runToCompletion();
+        report(sg, "alt_astar_run", result.visitOrder.size(), tq);
+    }
+    {
+        std::shared_ptr<ContractionHierarchy> hierarchy = std::make_shared<ContractionHierarchy>();
+        Timer t;
+        buildContractionHierarchy(*csr, graph.getVersion(), *hierarchy);
+        report(sg, "ch_preprocess", hierarchy->numShortcuts, t);
+
+        CHImpl ch;
+        Timer tq;
+        ch.setGraphCSR(csr);
+        ch.setHierarchy(hierarchy);
+        ch.setStartNodes(std::vector<Node *>{start, nodes[sg.numNodes - 1]});
+        const AlgoResult &result = ch.runToCompletion();
+        report(sg, "ch_query", result.visitOrder.size(), tq);
+    }
+
+    // unjoin a random tenth of the links
+    {
+        std::vector<EDGE> edges = sg.edges;
+        std::shuffle(edges.begin(), edges.end(), rng);
+        edges.resize(std::min<size_t>(edges.size() / 10 + 1, edges.size()));
+        Timer t;
+        for (const EDGE &e : edges)
+            graph.unJoinNodes(nodes[e.first], nodes[e.second]);
+        report(sg, "unjoin", edges.size(), t);
+    }
+
+    // delete a random tenth of the nodes
+    {
+        std::vector<uint32_t> order(sg.numNodes);
+        for (uint32_t i = 0; i < sg.numNodes; ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        order.resize(sg.numNodes / 10 + 1);
+        Timer t;
+        for (uint32_t i : order)
+            graph.deleteNode(nodes[i]);
+        report(sg, "delete", order.size(), t);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t maxEdges = 1000000;
+    std::string onlyGen = "";
+    unsigned seed = 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--max-edges") && i + 1 < argc)
+            maxEdges = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--gen") && i + 1 < argc)
+            onlyGen = argv[++i];
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--max-edges N] [--gen grid|er|geo|rmat] [--seed S] [--threads T]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the graph and engines log every operation, keep the CSV readable
+    std::cout.setstate(std::ios_base::failbit);
+    printf("generator,nodes,edges,operation,ops,total_ms,ns_per_op,ns_per_edge,peak_rss_kb,allocs_per_op\n");
+
+    std::mt19937 rng(seed);
+    WorkStealingPool pool(threads);
+    for (size_t edges = 1000; edges <= maxEdges; edges *= 10)
+    {
+        if (onlyGen.empty() || onlyGen == "grid")
+            benchGraph(makeGrid(edges), rng, pool);
+        if (onlyGen.empty() || onlyGen == "er")
+            benchGraph(makeErdosRenyi(edges, rng), rng, pool);
+        if (onlyGen.empty() || onlyGen == "geo")
+            benchGraph(makeGeometric(edges, rng), rng, pool);
+        if (onlyGen.empty() || onlyGen == "rmat")
+            benchGraph(makeRMAT(edges, rng), rng, pool);
+    }
+    return 0;
+}
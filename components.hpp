@@ -0,0 +1,190 @@
+/*
+components.hpp
+    - Union-find over the nodes' dense indices, tracks which all_graphs index each node's graph is stored at
+    - Merging two graphs is a union, splitting a graph gives the moved nodes fresh elements
+ */
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+// Disjoint sets with union by size and path compression
+class DisjointSets
+{
+private:
+    std::vector<uint32_t> parent; // <element, parent element> (roots are their own parent)
+    std::vector<uint32_t> sizes;  // <root element, number of elements in the set>
+
+public:
+    DisjointSets() {}
+
+    // Adds a new element in its own set and returns it
+    uint32_t add()
+    {
+        uint32_t e = parent.size();
+        parent.push_back(e);
+        sizes.push_back(1);
+        return e;
+    }
+
+    // Returns the root element of the set holding e
+    uint32_t find(uint32_t e)
+    {
+        uint32_t root = e;
+        while (parent[root] != root)
+            root = parent[root];
+
+        // point every element on the path straight at the root
+        while (parent[e] != root)
+        {
+            uint32_t next = parent[e];
+            parent[e] = root;
+            e = next;
+        }
+        return root;
+    }
+
+    // Merges the sets holding a and b, returns the root of the merged set
+    uint32_t unite(uint32_t a, uint32_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return a;
+
+        // hang the smaller set under the larger one
+        if (sizes[a] < sizes[b])
+            std::swap(a, b);
+        parent[b] = a;
+        sizes[a] += sizes[b];
+        return a;
+    }
+
+    inline size_t size() const
+    {
+        return parent.size();
+    }
+};
+
+// Tracks the graph (all_graphs index) of every node
+// Union-find can't split sets, so nodes moved to a new graph are given fresh elements and their old ones are left behind
+// Left behind elements are dropped by compacting once they outnumber the live ones
+class GraphComponents
+{
+private:
+    static constexpr uint32_t NO_ELEM = UINT32_MAX;
+
+    DisjointSets sets;
+    std::vector<uint32_t> elems; // <dense index, element of node> (NO_ELEM if index is unused)
+    std::vector<size_t> locs;    // <root element, all_graphs index of the set's graph>
+    size_t liveElems;            // Number of elements belonging to nodes
+    size_t deadElems;            // Number of elements left behind by moved or deleted nodes
+
+    // Gives the node at idx a fresh element in its own set
+    uint32_t newElem(uint32_t idx, size_t loc)
+    {
+        if (idx >= elems.size())
+            elems.resize(idx + 1, NO_ELEM);
+        uint32_t e = sets.add();
+        elems[idx] = e;
+        locs.push_back(loc);
+        return e;
+    }
+
+    // Rebuilds the sets from the live nodes only, one element per node
+    void compact()
+    {
+        DisjointSets oldSets;
+        std::vector<size_t> oldLocs;
+        std::vector<uint32_t> oldElems = elems;
+        std::swap(oldSets, sets);
+        std::swap(oldLocs, locs);
+
+        // every new element of a set is given the set's all_graphs index, so the merged root keeps it
+        std::vector<uint32_t> rootElem(oldSets.size(), NO_ELEM); // <old root, new element of the first node in the set>
+        for (uint32_t idx = 0; idx < oldElems.size(); ++idx)
+        {
+            if (oldElems[idx] == NO_ELEM)
+                continue;
+
+            uint32_t root = oldSets.find(oldElems[idx]);
+            uint32_t e = newElem(idx, oldLocs[root]);
+            if (rootElem[root] == NO_ELEM)
+                rootElem[root] = e;
+            else
+                sets.unite(rootElem[root], e);
+        }
+        deadElems = 0;
+    }
+
+    inline void compactIfNeeded()
+    {
+        if (deadElems > 1024 && deadElems > liveElems)
+            compact();
+    }
+
+public:
+    GraphComponents() : liveElems(0), deadElems(0) {}
+
+    // Adds the node at idx as its own graph stored at all_graphs index loc
+    void addNode(uint32_t idx, size_t loc)
+    {
+        assert(idx >= elems.size() || elems[idx] == NO_ELEM);
+        newElem(idx, loc);
+        liveElems++;
+    }
+
+    // Removes the node at idx, the rest of its graph is unaffected
+    void removeNode(uint32_t idx)
+    {
+        assert(idx < elems.size() && elems[idx] != NO_ELEM);
+        elems[idx] = NO_ELEM;
+        liveElems--;
+        deadElems++;
+        compactIfNeeded();
+    }
+
+    // Returns the all_graphs index of the graph holding the node at idx
+    inline size_t getLoc(uint32_t idx)
+    {
+        return locs[sets.find(elems[idx])];
+    }
+
+    // Whether the nodes at idx1 and idx2 are in the same graph
+    inline bool sameGraph(uint32_t idx1, uint32_t idx2)
+    {
+        return sets.find(elems[idx1]) == sets.find(elems[idx2]);
+    }
+
+    // Merges the graphs of the nodes at idx1 and idx2, the merged graph keeps idx1's all_graphs index
+    void merge(uint32_t idx1, uint32_t idx2)
+    {
+        size_t loc = getLoc(idx1);
+        locs[sets.unite(elems[idx1], elems[idx2])] = loc;
+    }
+
+    // Stores the graph holding the node at idx at all_graphs index loc
+    inline void setLoc(uint32_t idx, size_t loc)
+    {
+        locs[sets.find(elems[idx])] = loc;
+    }
+
+    // Moves the given nodes out of their graph into a new graph stored at all_graphs index loc
+    void moveNodes(const std::vector<uint32_t> &idxs, size_t loc)
+    {
+        if (idxs.empty())
+            return;
+
+        uint32_t first = NO_ELEM;
+        for (uint32_t idx : idxs)
+        {
+            uint32_t e = newElem(idx, loc);
+            first = first == NO_ELEM ? e : sets.unite(first, e);
+        }
+        locs[sets.find(first)] = loc;
+        deadElems += idxs.size();
+        compactIfNeeded();
+    }
+};
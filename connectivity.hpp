@@ -0,0 +1,536 @@
+/*
+connectivity.hpp
+    - Dynamic connectivity over the nodes' dense indices (Holm, de Lichtenberg and Thorup)
+    - Spanning forests are kept as Euler tour treaps, one forest per level
+    - Removing a link answers whether it split its graph in amortized polylog time
+ */
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+class DynamicConnectivity
+{
+private:
+    static constexpr uint8_t TREE_FLAG = 1;    // Vertex has tree edges at the occurrence's level
+    static constexpr uint8_t NONTREE_FLAG = 2; // Vertex has non tree edges at the occurrence's level
+
+    // Treap node of an Euler tour, either a vertex occurrence (from == to) or an arc from -> to of a tree edge
+    struct ETNode
+    {
+        ETNode *left, *right, *parent;
+        uint32_t prio;
+        uint32_t from, to;
+        uint32_t count;    // Nodes in subtree
+        uint32_t vertices; // Vertex occurrences in subtree
+        uint8_t flags;     // Own TREE_FLAG/NONTREE_FLAG, only set on vertex occurrences
+        uint8_t subFlags;  // Flags of every node in subtree
+
+        ETNode(uint32_t f, uint32_t t, uint32_t p) : left(NULL), right(NULL), parent(NULL), prio(p), from(f), to(t), count(1), vertices(f == t), flags(0), subFlags(0) {}
+    };
+
+    // Spanning forest of the edges with level >= the level's index, plus the adjacency of edges at exactly this level
+    struct Level
+    {
+        std::vector<ETNode *> verts;                                    // <vertex, occurrence> (NULL if vertex is alone at this level)
+        std::unordered_map<uint32_t, std::vector<uint32_t>> treeAdj;    // <vertex, tree edge neighbours>
+        std::unordered_map<uint32_t, std::vector<uint32_t>> nontreeAdj; // <vertex, non tree edge neighbours>
+    };
+
+    struct EdgeInfo
+    {
+        uint32_t level;
+        bool tree;
+        std::vector<std::pair<ETNode *, ETNode *>> arcs; // <level, both arcs of a tree edge in that level's tour>
+    };
+
+    std::vector<Level> levels;
+    std::unordered_map<uint64_t, EdgeInfo> edges; // <packed vertex pair, edge>
+    uint32_t seed;                                // Treap priority generator state
+
+    /*
+        Euler tour treap helpers
+    */
+
+    inline static uint32_t countOf(const ETNode *t)
+    {
+        return t ? t->count : 0;
+    }
+
+    inline static void update(ETNode *t)
+    {
+        t->count = 1 + countOf(t->left) + countOf(t->right);
+        t->vertices = (t->from == t->to) + (t->left ? t->left->vertices : 0) + (t->right ? t->right->vertices : 0);
+        t->subFlags = t->flags | (t->left ? t->left->subFlags : 0) | (t->right ? t->right->subFlags : 0);
+    }
+
+    static ETNode *merge(ETNode *a, ETNode *b)
+    {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+
+        if (a->prio > b->prio)
+        {
+            a->right = merge(a->right, b);
+            a->right->parent = a;
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        b->left->parent = b;
+        update(b);
+        return b;
+    }
+
+    // Splits t into its first k nodes (a) and the rest (b)
+    static void split(ETNode *t, uint32_t k, ETNode *&a, ETNode *&b)
+    {
+        if (!t)
+        {
+            a = b = NULL;
+            return;
+        }
+
+        if (countOf(t->left) >= k)
+        {
+            split(t->left, k, a, t->left);
+            if (t->left)
+                t->left->parent = t;
+            b = t;
+        }
+        else
+        {
+            split(t->right, k - countOf(t->left) - 1, t->right, b);
+            if (t->right)
+                t->right->parent = t;
+            a = t;
+        }
+        update(t);
+    }
+
+    // Concatenates two tours and returns the root of the result
+    static ETNode *join(ETNode *a, ETNode *b)
+    {
+        ETNode *r = merge(a, b);
+        if (r)
+            r->parent = NULL;
+        return r;
+    }
+
+    // Splits the tour holding t into its first k nodes and the rest, both become roots
+    static void splitRoot(ETNode *t, uint32_t k, ETNode *&a, ETNode *&b)
+    {
+        split(t, k, a, b);
+        if (a)
+            a->parent = NULL;
+        if (b)
+            b->parent = NULL;
+    }
+
+    static ETNode *rootOf(ETNode *t)
+    {
+        while (t->parent)
+            t = t->parent;
+        return t;
+    }
+
+    // Position of t in its tour
+    static uint32_t indexOf(ETNode *t)
+    {
+        uint32_t idx = countOf(t->left);
+        while (t->parent)
+        {
+            if (t == t->parent->right)
+                idx += countOf(t->parent->left) + 1;
+            t = t->parent;
+        }
+        return idx;
+    }
+
+    // First vertex occurrence in t's subtree with the given flag
+    static ETNode *findFlagged(ETNode *t, uint8_t flag)
+    {
+        while (t && (t->subFlags & flag))
+        {
+            if (t->left && (t->left->subFlags & flag))
+                t = t->left;
+            else if (t->flags & flag)
+                return t;
+            else
+                t = t->right;
+        }
+        return NULL;
+    }
+
+    static void collectVertices(const ETNode *t, std::vector<uint32_t> &out)
+    {
+        if (!t)
+            return;
+        collectVertices(t->left, out);
+        if (t->from == t->to)
+            out.push_back(t->from);
+        collectVertices(t->right, out);
+    }
+
+    static void freeTree(ETNode *t)
+    {
+        if (!t)
+            return;
+        freeTree(t->left);
+        freeTree(t->right);
+        delete t;
+    }
+
+    inline uint32_t nextPrio()
+    {
+        // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    inline static uint64_t edgeKey(uint32_t u, uint32_t v)
+    {
+        if (u > v)
+            std::swap(u, v);
+        return ((uint64_t)u << 32) | v;
+    }
+
+    /*
+        Per level forest helpers
+    */
+
+    Level &getLevel(uint32_t i)
+    {
+        while (levels.size() <= i)
+            levels.push_back(Level());
+        return levels[i];
+    }
+
+    // Returns x's occurrence at level i, creating it if x was alone at that level
+    ETNode *getVert(uint32_t i, uint32_t x)
+    {
+        Level &L = getLevel(i);
+        if (x >= L.verts.size())
+            L.verts.resize(x + 1, NULL);
+        if (!L.verts[x])
+            L.verts[x] = new ETNode(x, x, nextPrio());
+        return L.verts[x];
+    }
+
+    inline ETNode *peekVert(uint32_t i, uint32_t x) const
+    {
+        if (i >= levels.size() || x >= levels[i].verts.size())
+            return NULL;
+        return levels[i].verts[x];
+    }
+
+    // Refreshes x's flags at level i from its adjacency
+    void setFlags(uint32_t i, uint32_t x)
+    {
+        ETNode *t = peekVert(i, x);
+        if (!t)
+            return;
+
+        Level &L = levels[i];
+        uint8_t flags = 0;
+        if (L.treeAdj.count(x))
+            flags |= TREE_FLAG;
+        if (L.nontreeAdj.count(x))
+            flags |= NONTREE_FLAG;
+        if (flags == t->flags)
+            return;
+
+        t->flags = flags;
+        for (; t; t = t->parent)
+            update(t);
+    }
+
+    static void addAdj(std::unordered_map<uint32_t, std::vector<uint32_t>> &adj, uint32_t x, uint32_t y)
+    {
+        adj[x].push_back(y);
+    }
+
+    static void remAdj(std::unordered_map<uint32_t, std::vector<uint32_t>> &adj, uint32_t x, uint32_t y)
+    {
+        auto it = adj.find(x);
+        assert(it != adj.end());
+        std::vector<uint32_t> &n = it->second;
+        for (size_t i = 0; i < n.size(); ++i)
+        {
+            if (n[i] == y)
+            {
+                n[i] = n.back();
+                n.pop_back();
+                break;
+            }
+        }
+        if (n.empty())
+            adj.erase(it);
+    }
+
+    // Rotates x's tour so it starts at x's occurrence
+    void reroot(uint32_t i, uint32_t x)
+    {
+        ETNode *t = getVert(i, x);
+        ETNode *a, *b;
+        splitRoot(rootOf(t), indexOf(t), a, b);
+        join(b, a);
+    }
+
+    // Links the level i trees of u and v, returns the two arcs of the new tree edge
+    std::pair<ETNode *, ETNode *> link(uint32_t i, uint32_t u, uint32_t v)
+    {
+        reroot(i, u);
+        reroot(i, v);
+        ETNode *uv = new ETNode(u, v, nextPrio());
+        ETNode *vu = new ETNode(v, u, nextPrio());
+        join(join(join(rootOf(getVert(i, u)), uv), rootOf(getVert(i, v))), vu);
+        return std::pair<ETNode *, ETNode *>(uv, vu);
+    }
+
+    // Removes a tree edge given by its two arcs from a tour, splitting it in two
+    static void cut(ETNode *a, ETNode *b)
+    {
+        uint32_t ia = indexOf(a), ib = indexOf(b);
+        if (ia > ib)
+        {
+            std::swap(a, b);
+            std::swap(ia, ib);
+        }
+
+        // tour is A a B b C, B is one side of the edge and C A the other
+        ETNode *A, *rest, *arc, *B, *C;
+        splitRoot(rootOf(a), ia, A, rest);
+        splitRoot(rest, 1, arc, rest);
+        splitRoot(rest, ib - ia - 1, B, rest);
+        splitRoot(rest, 1, arc, C);
+        join(C, A);
+
+        delete a;
+        delete b;
+    }
+
+    inline bool connectedAt(uint32_t i, uint32_t u, uint32_t v) const
+    {
+        if (u == v)
+            return true;
+        ETNode *a = peekVert(i, u), *b = peekVert(i, v);
+        return a && b && rootOf(a) == rootOf(b);
+    }
+
+    inline uint32_t treeSize(uint32_t i, uint32_t x) const
+    {
+        ETNode *t = peekVert(i, x);
+        return t ? rootOf(t)->vertices : 1;
+    }
+
+    // Looks for an edge reconnecting u's and v's level i trees after a tree edge between them was cut
+    // Edges of the smaller tree that don't reconnect are pushed up a level so each edge is only scanned O(log n) times
+    bool replace(uint32_t i, uint32_t u, uint32_t v)
+    {
+        uint32_t x = treeSize(i, u) <= treeSize(i, v) ? u : v;
+        getLevel(i + 1);
+        ETNode *t = getVert(i, x);
+
+        // move the smaller tree's level i tree edges to level i + 1
+        while (ETNode *f = findFlagged(rootOf(t), TREE_FLAG))
+        {
+            uint32_t a = f->from;
+            std::vector<uint32_t> adj;
+            std::swap(adj, levels[i].treeAdj[a]);
+            levels[i].treeAdj.erase(a);
+            setFlags(i, a);
+
+            for (uint32_t b : adj)
+            {
+                remAdj(levels[i].treeAdj, b, a);
+                setFlags(i, b);
+
+                EdgeInfo &e = edges[edgeKey(a, b)];
+                e.level = i + 1;
+                e.arcs.push_back(link(i + 1, a, b));
+                addAdj(levels[i + 1].treeAdj, a, b);
+                addAdj(levels[i + 1].treeAdj, b, a);
+                setFlags(i + 1, a);
+                setFlags(i + 1, b);
+            }
+        }
+
+        // scan the smaller tree's level i non tree edges for one leaving the tree
+        while (ETNode *f = findFlagged(rootOf(t), NONTREE_FLAG))
+        {
+            uint32_t a = f->from;
+            while (levels[i].nontreeAdj.count(a))
+            {
+                uint32_t b = levels[i].nontreeAdj[a].back();
+                remAdj(levels[i].nontreeAdj, a, b);
+                remAdj(levels[i].nontreeAdj, b, a);
+                setFlags(i, a);
+                setFlags(i, b);
+
+                EdgeInfo &e = edges[edgeKey(a, b)];
+                if (connectedAt(i, a, b))
+                {
+                    // both ends in the smaller tree
+                    e.level = i + 1;
+                    addAdj(levels[i + 1].nontreeAdj, a, b);
+                    addAdj(levels[i + 1].nontreeAdj, b, a);
+                    setFlags(i + 1, a);
+                    setFlags(i + 1, b);
+                }
+                else
+                {
+                    // replacement edge becomes a tree edge in every forest up to level i
+                    e.tree = true;
+                    for (uint32_t j = 0; j <= i; ++j)
+                        e.arcs.push_back(link(j, a, b));
+                    addAdj(levels[i].treeAdj, a, b);
+                    addAdj(levels[i].treeAdj, b, a);
+                    setFlags(i, a);
+                    setFlags(i, b);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+public:
+    DynamicConnectivity() : seed(2463534242u)
+    {
+        getLevel(0);
+    }
+
+    DynamicConnectivity(const DynamicConnectivity &) = delete;
+    DynamicConnectivity &operator=(const DynamicConnectivity &) = delete;
+
+    ~DynamicConnectivity()
+    {
+        // every arc lies in a tour with its vertices, so freeing each tour once frees everything
+        for (Level &L : levels)
+        {
+            std::unordered_set<ETNode *> roots;
+            for (ETNode *t : L.verts)
+            {
+                if (t)
+                    roots.insert(rootOf(t));
+            }
+            for (ETNode *r : roots)
+                freeTree(r);
+        }
+    }
+
+    // Adds vertex x with no edges
+    void addVertex(uint32_t x)
+    {
+        assert(!peekVert(0, x));
+        getVert(0, x);
+    }
+
+    // Removes vertex x, it must not have any edges left
+    void removeVertex(uint32_t x)
+    {
+        for (uint32_t i = 0; i < levels.size(); ++i)
+        {
+            ETNode *t = peekVert(i, x);
+            if (!t)
+                continue;
+            assert(t->count == 1 && !levels[i].treeAdj.count(x) && !levels[i].nontreeAdj.count(x));
+            delete t;
+            levels[i].verts[x] = NULL;
+        }
+    }
+
+    // Adds an edge between u and v, does nothing if they're already linked
+    void addEdge(uint32_t u, uint32_t v)
+    {
+        assert(u != v);
+        uint64_t key = edgeKey(u, v);
+        if (edges.count(key))
+            return;
+
+        EdgeInfo &e = edges[key];
+        e.level = 0;
+        e.tree = !connectedAt(0, u, v);
+        if (e.tree)
+        {
+            e.arcs.push_back(link(0, u, v));
+            addAdj(levels[0].treeAdj, u, v);
+            addAdj(levels[0].treeAdj, v, u);
+        }
+        else
+        {
+            addAdj(levels[0].nontreeAdj, u, v);
+            addAdj(levels[0].nontreeAdj, v, u);
+        }
+        setFlags(0, u);
+        setFlags(0, v);
+    }
+
+    // Removes the edge between u and v, returns true if u and v are no longer connected
+    bool removeEdge(uint32_t u, uint32_t v)
+    {
+        auto it = edges.find(edgeKey(u, v));
+        if (it == edges.end())
+            return false;
+
+        EdgeInfo e = std::move(it->second);
+        edges.erase(it);
+
+        Level &L = levels[e.level];
+        if (!e.tree)
+        {
+            remAdj(L.nontreeAdj, u, v);
+            remAdj(L.nontreeAdj, v, u);
+            setFlags(e.level, u);
+            setFlags(e.level, v);
+            return false;
+        }
+
+        remAdj(L.treeAdj, u, v);
+        remAdj(L.treeAdj, v, u);
+        setFlags(e.level, u);
+        setFlags(e.level, v);
+        for (std::pair<ETNode *, ETNode *> &arcs : e.arcs)
+            cut(arcs.first, arcs.second);
+
+        // look for a replacement from the edge's level down
+        for (uint32_t i = e.level + 1; i-- > 0;)
+        {
+            if (replace(i, u, v))
+                return false;
+        }
+        return true;
+    }
+
+    inline bool connected(uint32_t u, uint32_t v) const
+    {
+        return connectedAt(0, u, v);
+    }
+
+    // Number of vertices connected to x
+    inline size_t componentSize(uint32_t x) const
+    {
+        return treeSize(0, x);
+    }
+
+    // Identifies x's component, only valid until the next change
+    inline uintptr_t componentKey(uint32_t x) const
+    {
+        return (uintptr_t)rootOf(peekVert(0, x));
+    }
+
+    // Appends every vertex connected to x to out
+    void collectComponent(uint32_t x, std::vector<uint32_t> &out) const
+    {
+        collectVertices(rootOf(peekVert(0, x)), out);
+    }
+};
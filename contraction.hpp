@@ -0,0 +1,404 @@
+/*
+contraction.hpp
+    - Contraction hierarchies for fast shortest path queries on graphs that rarely change
+    - Nodes are contracted one by one in order of their edge difference, shortcuts keep the weights between the nodes left
+    - The result is an upward and a downward CSR that point to point queries search from both ends
+    - Nodes too dense to contract cheaply are left in a core that keeps its arcs both ways
+    - Contraction runs on a background thread from a copy of the CSR, queries wait until the hierarchy matches the graph
+ */
+#pragma once
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include "csr.hpp"
+#include "heap.hpp"
+#include "graph.hpp"
+
+#define CH_WITNESS_SETTLE_LIMIT 64 // Nodes a witness search settles before giving up, a shortcut is added if no witness was found by then
+#define CH_CORE_ARC_PAIRS 256      // Contraction stops once every node left has more in and out arc pairs than this, those nodes form the core
+#define CH_SETTLE_MS 500           // Time the graph has to go unchanged before it is contracted again
+
+static constexpr uint32_t CH_NO_MID = UINT32_MAX; // Middle node of an arc that is an original link
+static constexpr uint32_t CH_NO_RANK = UINT32_MAX; // Rank of an unused dense index
+
+// Arc of the hierarchy, a shortcut if it has a middle node
+struct CHArc
+{
+    uint32_t node; // Dense index of the arc's other end
+    uint32_t mid;  // Node the shortcut was contracted through (CH_NO_MID if an original link)
+    ll weight;
+};
+
+struct ContractionHierarchy
+{
+    size_t version;                  // Graph version the hierarchy was built for
+    size_t numNodes;                 // Size of the CSR the hierarchy was built from
+    size_t numShortcuts;             // Arcs added by contraction
+    size_t coreNodes;                // Nodes left uncontracted, ranked highest
+    double buildMs;                  // Time contracting the graph took
+    std::vector<uint32_t> rank;      // <dense index, position in the contraction order> (CH_NO_RANK if index is unused)
+    std::vector<uint32_t> upBegin;   // <dense index, first of the node's arcs in up>, one past the last node ends up
+    std::vector<CHArc> up;           // Arcs from each node to higher ranked nodes
+    std::vector<uint32_t> downBegin; // <dense index, first of the node's arcs in down>, one past the last node ends down
+    std::vector<CHArc> down;         // Arcs into each node from higher ranked nodes, node is the arc's tail
+};
+
+// Contracts the graph's nodes, keeping the arcs between the nodes not yet contracted as adjacency lists
+class CHBuilder
+{
+private:
+    const GraphCSR &csr;
+    std::vector<std::vector<CHArc>> out; // <dense index, arcs to uncontracted nodes>
+    std::vector<std::vector<CHArc>> in;  // <dense index, arcs from uncontracted nodes, node is the arc's tail>
+    std::vector<ll> contractedNeighbors; // <dense index, number of neighbors already contracted>
+
+    // Witness search state, dist is reset through touched after every search
+    IndexedHeap<4> witnessQueue;
+    std::vector<ll> witnessDist;     // <dense index, weight from the search's root> (-1 if unreached)
+    std::vector<uint8_t> isTarget;   // <dense index, whether the node is linked from the node being contracted>
+    std::vector<uint32_t> touched;
+
+    // Adds the arc to list, or lowers the weight of the arc already there to the same node
+    static bool addToList(std::vector<CHArc> &list, const CHArc &arc)
+    {
+        for (CHArc &a : list)
+        {
+            if (a.node == arc.node)
+            {
+                if (arc.weight >= a.weight)
+                    return false;
+                a = arc;
+                return true;
+            }
+        }
+        list.push_back(arc);
+        return true;
+    }
+
+    static void removeFromList(std::vector<CHArc> &list, uint32_t node)
+    {
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (list[i].node == node)
+            {
+                list[i] = list.back();
+                list.pop_back();
+                return;
+            }
+        }
+    }
+
+    // Returns whether the arc from tail to head is new or shorter than the one there
+    bool addArc(uint32_t tail, uint32_t head, ll weight, uint32_t mid)
+    {
+        if (!addToList(out[tail], CHArc{head, mid, weight}))
+            return false;
+        addToList(in[head], CHArc{tail, mid, weight});
+        return true;
+    }
+
+    // Dijkstra from root over the uncontracted nodes other than skip
+    // Stops once every target is settled, past maxWeight or after CH_WITNESS_SETTLE_LIMIT settled nodes
+    void witnessSearch(uint32_t root, uint32_t skip, ll maxWeight, size_t targets)
+    {
+        for (uint32_t idx : touched)
+            witnessDist[idx] = -1;
+        touched.clear();
+        witnessQueue.clear();
+
+        witnessDist[root] = 0;
+        touched.push_back(root);
+        witnessQueue.push(root, 0);
+        for (size_t settled = 0; !witnessQueue.empty() && settled < CH_WITNESS_SETTLE_LIMIT; ++settled)
+        {
+            uint32_t currIdx = witnessQueue.pop();
+            if (witnessDist[currIdx] > maxWeight || (isTarget[currIdx] && --targets == 0))
+                break;
+
+            for (const CHArc &arc : out[currIdx])
+            {
+                if (arc.node == skip)
+                    continue;
+                ll newWeight = witnessDist[currIdx] + arc.weight;
+                if (witnessDist[arc.node] == -1)
+                    touched.push_back(arc.node);
+                else if (newWeight >= witnessDist[arc.node])
+                    continue;
+                witnessDist[arc.node] = newWeight;
+                witnessQueue.push(arc.node, newWeight);
+            }
+        }
+    }
+
+    // Shortcuts contracting v needs, one for each path through v that no witness path is as short as
+    // Only counts them unless add is set
+    size_t shortcuts(uint32_t v, bool add)
+    {
+        size_t count = 0;
+        for (const CHArc &outArc : out[v])
+            isTarget[outArc.node] = 1;
+        for (size_t i = 0; i < in[v].size(); ++i)
+        {
+            const CHArc inArc = in[v][i];
+            ll maxOut = -1;
+            for (const CHArc &outArc : out[v])
+            {
+                if (outArc.node != inArc.node)
+                    maxOut = std::max(maxOut, outArc.weight);
+            }
+            if (maxOut == -1)
+                continue;
+
+            witnessSearch(inArc.node, v, inArc.weight + maxOut, out[v].size());
+            for (size_t j = 0; j < out[v].size(); ++j)
+            {
+                const CHArc outArc = out[v][j];
+                ll via = inArc.weight + outArc.weight;
+                if (outArc.node == inArc.node || (witnessDist[outArc.node] != -1 && witnessDist[outArc.node] <= via))
+                    continue;
+                count++;
+                if (add)
+                    addArc(inArc.node, outArc.node, via, v);
+            }
+        }
+        for (const CHArc &outArc : out[v])
+            isTarget[outArc.node] = 0;
+        return count;
+    }
+
+    inline size_t arcPairs(uint32_t v) const
+    {
+        return in[v].size() * out[v].size();
+    }
+
+    // Edge difference plus contracted neighbors, lower is contracted first
+    // Nodes with too many arc pairs to search witnesses for count every pair as a shortcut
+    ll priority(uint32_t v)
+    {
+        size_t added = arcPairs(v) > CH_CORE_ARC_PAIRS ? arcPairs(v) : shortcuts(v, false);
+        return (ll)added - (ll)(in[v].size() + out[v].size()) + contractedNeighbors[v];
+    }
+
+public:
+    CHBuilder(const GraphCSR &graphCSR) : csr(graphCSR) {}
+
+    void build(size_t version, ContractionHierarchy &ch)
+    {
+        size_t numNodes = csr.numNodes();
+        ch.version = version;
+        ch.numNodes = numNodes;
+        ch.numShortcuts = 0;
+        ch.coreNodes = 0;
+        ch.rank.assign(numNodes, CH_NO_RANK);
+        out.assign(numNodes, std::vector<CHArc>());
+        in.assign(numNodes, std::vector<CHArc>());
+        contractedNeighbors.assign(numNodes, 0);
+        witnessDist.assign(numNodes, -1);
+        isTarget.assign(numNodes, 0);
+        touched.clear();
+
+        for (uint32_t idx = 0; idx < numNodes; ++idx)
+        {
+            for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+            {
+                if (csr.canTravel(e) && csr.targets[e] != idx)
+                    addArc(idx, csr.targets[e], csr.weights[e], CH_NO_MID);
+            }
+        }
+
+        IndexedHeap<4> order;
+        order.reserve(numNodes);
+        for (uint32_t idx = 0; idx < numNodes; ++idx)
+        {
+            if (csr.nodes[idx])
+                order.push(idx, priority(idx));
+        }
+
+        // Arcs each node had to the nodes left when it was contracted, those are all ranked higher
+        std::vector<std::vector<CHArc>> upArcs(numNodes), downArcs(numNodes);
+        std::vector<uint32_t> core;
+        uint32_t nextRank = 0;
+        while (!order.empty())
+        {
+            // Lazy updates, a node whose priority grew since it was queued goes back if it isn't the smallest anymore
+            uint32_t v = order.pop();
+            ll p = priority(v);
+            if (!order.empty() && p > order.getKey(order.top()))
+            {
+                order.push(v, p);
+                continue;
+            }
+
+            // Dense nodes would cost more to contract than searching them does, they are left to the core
+            if (arcPairs(v) > CH_CORE_ARC_PAIRS)
+            {
+                core.push_back(v);
+                continue;
+            }
+
+            ch.rank[v] = nextRank++;
+            upArcs[v] = out[v];
+            downArcs[v] = in[v];
+            ch.numShortcuts += shortcuts(v, true);
+
+            // Shortcuts are in place, v leaves the remaining graph
+            for (const CHArc &arc : out[v])
+            {
+                removeFromList(in[arc.node], v);
+                contractedNeighbors[arc.node]++;
+            }
+            for (const CHArc &arc : in[v])
+            {
+                removeFromList(out[arc.node], v);
+                contractedNeighbors[arc.node]++;
+            }
+            std::vector<CHArc>().swap(out[v]);
+            std::vector<CHArc>().swap(in[v]);
+        }
+
+        // Core nodes rank above every contracted node and keep all arcs between them both ways
+        // Queries search the core like plain bidirectional Dijkstra once they climb into it
+        ch.coreNodes = core.size();
+        for (uint32_t v : core)
+        {
+            ch.rank[v] = nextRank++;
+            upArcs[v].swap(out[v]);
+            downArcs[v].swap(in[v]);
+        }
+
+        ch.upBegin.assign(numNodes + 1, 0);
+        ch.downBegin.assign(numNodes + 1, 0);
+        ch.up.clear();
+        ch.down.clear();
+        for (uint32_t idx = 0; idx < numNodes; ++idx)
+        {
+            ch.upBegin[idx] = ch.up.size();
+            ch.up.insert(ch.up.end(), upArcs[idx].begin(), upArcs[idx].end());
+            ch.downBegin[idx] = ch.down.size();
+            ch.down.insert(ch.down.end(), downArcs[idx].begin(), downArcs[idx].end());
+        }
+        ch.upBegin[numNodes] = ch.up.size();
+        ch.downBegin[numNodes] = ch.down.size();
+    }
+};
+
+// Contracts every node of csr into ch
+inline void buildContractionHierarchy(const GraphCSR &csr, size_t version, ContractionHierarchy &ch)
+{
+    CHBuilder builder(csr);
+    builder.build(version, ch);
+}
+
+// Arc in arcs[begin[idx], begin[idx + 1]) to node
+inline const CHArc &findCHArc(const std::vector<uint32_t> &begin, const std::vector<CHArc> &arcs, uint32_t idx, uint32_t node)
+{
+    for (uint32_t a = begin[idx]; a < begin[idx + 1]; ++a)
+    {
+        if (arcs[a].node == node)
+            return arcs[a];
+    }
+    assert(false && "Shortcut half is missing from the hierarchy");
+    return arcs[begin[idx]];
+}
+
+// Appends the original links the arc from tail to head stands for to path, each as <node it leads to, weight>
+// The shortcut's halves are arcs of its middle node, which was contracted before both of its ends
+inline void unpackCHArc(const ContractionHierarchy &ch, uint32_t tail, uint32_t head, uint32_t mid, ll weight, std::vector<CHArc> &path)
+{
+    // Arcs left to unpack with their tails, the top is the next one along the path
+    std::vector<uint32_t> tails{tail};
+    std::vector<CHArc> arcs{CHArc{head, mid, weight}};
+    while (!arcs.empty())
+    {
+        uint32_t from = tails.back();
+        CHArc arc = arcs.back();
+        tails.pop_back();
+        arcs.pop_back();
+        if (arc.mid == CH_NO_MID)
+        {
+            path.push_back(arc);
+            continue;
+        }
+
+        const CHArc &second = findCHArc(ch.upBegin, ch.up, arc.mid, arc.node);
+        const CHArc &first = findCHArc(ch.downBegin, ch.down, arc.mid, from);
+        tails.push_back(arc.mid);
+        arcs.push_back(CHArc{arc.node, second.mid, second.weight});
+        tails.push_back(from);
+        arcs.push_back(CHArc{arc.mid, first.mid, first.weight});
+    }
+}
+
+// Keeps a contraction hierarchy for the graph, contracting it again on a background thread once edits to the graph settle
+class Hierarchy
+{
+private:
+    std::shared_ptr<const ContractionHierarchy> built; // Last finished hierarchy (NULL if none)
+    std::shared_ptr<ContractionHierarchy> pending;     // Hierarchy the worker is filling (NULL if not contracting)
+    std::thread worker;
+    std::atomic<bool> workerDone;
+    size_t seenVersion;                                // Graph version the last update saw
+    std::chrono::steady_clock::time_point changedTime; // When the last update saw the version change
+
+    // Worker thread, csr is the worker's own copy
+    static void compute(GraphCSR csr, size_t version, std::shared_ptr<ContractionHierarchy> out, std::atomic<bool> *done)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        buildContractionHierarchy(csr, version, *out);
+        out->buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        done->store(true, std::memory_order_release);
+    }
+
+public:
+    Hierarchy() : workerDone(false), seenVersion(SIZE_MAX) {}
+
+    // Called every frame CH is picked, collects a finished hierarchy and starts a new one once the graph has gone unchanged for CH_SETTLE_MS
+    void update(Graph &graph)
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (graph.getVersion() != seenVersion)
+        {
+            seenVersion = graph.getVersion();
+            changedTime = now;
+        }
+
+        // Hierarchies finished after another edit are dropped, the next one starts once edits settle
+        if (pending && workerDone.load(std::memory_order_acquire))
+        {
+            worker.join();
+            if (pending->version == graph.getVersion())
+                built = pending;
+            pending.reset();
+        }
+
+        bool fresh = built && built->version == graph.getVersion();
+        bool settled = now - changedTime >= std::chrono::milliseconds(CH_SETTLE_MS);
+        if (!fresh && !pending && settled && graph.getNumGraphs() > 0)
+        {
+            pending = std::make_shared<ContractionHierarchy>();
+            workerDone.store(false, std::memory_order_relaxed);
+            worker = std::thread(compute, graph.buildCSR(), graph.getVersion(), pending, &workerDone);
+        }
+    }
+
+    // Hierarchy for the graph as it is now, NULL while the graph has changed since the last one was built
+    std::shared_ptr<const ContractionHierarchy> get(const Graph &graph) const
+    {
+        if (built && built->version == graph.getVersion())
+            return built;
+        return NULL;
+    }
+
+    inline bool isComputing() const
+    {
+        return pending != NULL;
+    }
+
+    ~Hierarchy()
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+};
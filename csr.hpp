@@ -0,0 +1,250 @@
+/*
+csr.hpp
+    - Link store of the graph, every node's links are a segment of parallel edge arrays (compressed sparse rows)
+    - Nodes are addressed by their dense 32 bit index, the graph edits the segments in place as it links, unlinks and deletes nodes
+    - A segment that outgrows its room moves to the end of the arrays, the arrays are compacted when too much space is unused
+    - Node identifiers and positions are kept alongside so the engines never read the nodes themselves
+ */
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "node.hpp"
+
+static constexpr uint32_t CSR_NO_EDGE = UINT32_MAX; // Edge slot of a link that doesn't exist
+
+class GraphCSR
+{
+private:
+    std::vector<uint32_t> capacity; // <dense index, edge slots reserved for the node>
+    size_t usedEdges;               // Number of edge slots holding a node's links
+    size_t garbageEdges;            // Edge slots left behind when segments moved or their node was removed
+
+    static inline void setBit(std::vector<uint64_t> &bits, uint32_t e, bool on)
+    {
+        if (on)
+            bits[e >> 6] |= (1ULL << (e & 63));
+        else
+            bits[e >> 6] &= ~(1ULL << (e & 63));
+    }
+
+    static inline bool getBit(const std::vector<uint64_t> &bits, uint32_t e)
+    {
+        return (bits[e >> 6] >> (e & 63)) & 1ULL;
+    }
+
+    // Grows the edge arrays so they can hold n edge slots
+    void fitEdges(size_t n)
+    {
+        if (n > targets.size())
+        {
+            targets.resize(n);
+            weights.resize(n);
+            traversable.resize((n + 63) / 64, 0);
+            traversableBack.resize((n + 63) / 64, 0);
+        }
+    }
+
+    void copySlot(uint32_t from, uint32_t to)
+    {
+        targets[to] = targets[from];
+        weights[to] = weights[from];
+        setBit(traversable, to, getBit(traversable, from));
+        setBit(traversableBack, to, getBit(traversableBack, from));
+    }
+
+    // Moves the node's segment to the end of the arrays with room for at least one more link
+    void growSegment(uint32_t idx)
+    {
+        uint32_t degree = degrees[idx];
+        uint32_t offset = targets.size();
+        uint32_t room = degree + degree / 2 + 2;
+        fitEdges(offset + room);
+        for (uint32_t i = 0; i < degree; ++i)
+            copySlot(offsets[idx] + i, offset + i);
+
+        garbageEdges += capacity[idx];
+        offsets[idx] = offset;
+        capacity[idx] = room;
+    }
+
+public:
+    std::vector<Node *> nodes;             // <dense index, Node> (NULL if index is unused)
+    std::vector<ll> idents;                // <dense index, node identifier>
+    std::vector<uint32_t> offsets;         // <dense index, first edge slot of node>
+    std::vector<uint32_t> degrees;         // <dense index, number of links of node>
+    std::vector<sf::Vector2f> positions;   // <dense index, center of node on the interface>
+    std::vector<uint32_t> targets;         // <edge slot, dense index of linked node>
+    std::vector<ll> weights;               // <edge slot, link weight>
+    std::vector<uint64_t> traversable;     // Bit per edge slot, set if the node can travel to the linked node
+    std::vector<uint64_t> traversableBack; // Bit per edge slot, set if the linked node can travel to the node (for searching backward)
+
+    GraphCSR() : usedEdges(0), garbageEdges(0) {}
+
+    inline size_t numNodes() const
+    {
+        return nodes.size();
+    }
+
+    inline size_t numEdges() const
+    {
+        return usedEdges;
+    }
+
+    inline uint32_t edgesBegin(uint32_t idx) const
+    {
+        return offsets[idx];
+    }
+
+    inline uint32_t edgesEnd(uint32_t idx) const
+    {
+        return offsets[idx] + degrees[idx];
+    }
+
+    inline bool canTravel(uint32_t e) const
+    {
+        return getBit(traversable, e);
+    }
+
+    // Whether the edge slot's linked node can travel to the slot's node
+    inline bool canTravelBack(uint32_t e) const
+    {
+        return getBit(traversableBack, e);
+    }
+
+    // Edge slot of the node's link to target, CSR_NO_EDGE if they aren't linked
+    uint32_t findEdge(uint32_t idx, uint32_t target) const
+    {
+        for (uint32_t e = edgesBegin(idx); e < edgesEnd(idx); ++e)
+        {
+            if (targets[e] == target)
+                return e;
+        }
+        return CSR_NO_EDGE;
+    }
+
+    // Moves a node in the store, moving leaves the links as they are so nothing else has to change
+    inline void setPosition(uint32_t idx, const sf::Vector2f &pos)
+    {
+        if (idx < positions.size())
+            positions[idx] = pos;
+    }
+
+    // Places n at its dense index without any links, a reused index starts with no room and grows a segment on its first link
+    void addNode(Node *n)
+    {
+        uint32_t idx = n->getNodeIdx();
+        if (idx >= nodes.size())
+        {
+            nodes.resize(idx + 1, NULL);
+            idents.resize(idx + 1, -1);
+            offsets.resize(idx + 1, targets.size());
+            degrees.resize(idx + 1, 0);
+            capacity.resize(idx + 1, 0);
+            positions.resize(idx + 1);
+        }
+        assert(!nodes[idx] && degrees[idx] == 0);
+        nodes[idx] = n;
+        idents[idx] = n->getNodeIdent();
+        positions[idx] = n->getNodePos();
+    }
+
+    // Frees a dense index and drops the node's own links, the links to it have to be removed from the linked nodes
+    // The node's segment is left as garbage for compact
+    void removeNode(uint32_t idx)
+    {
+        usedEdges -= degrees[idx];
+        garbageEdges += capacity[idx];
+        degrees[idx] = 0;
+        capacity[idx] = 0;
+        nodes[idx] = NULL;
+        idents[idx] = -1;
+    }
+
+    // Appends the node's link to target, travel is whether the node can travel to target
+    // Travelling back is read from target's link to the node if target has added its end already
+    void addEdge(uint32_t idx, uint32_t target, ll weight, bool travel)
+    {
+        if (degrees[idx] == capacity[idx])
+            growSegment(idx);
+
+        uint32_t e = offsets[idx] + degrees[idx]++;
+        usedEdges++;
+        targets[e] = target;
+        weights[e] = weight;
+        setBit(traversable, e, travel);
+
+        uint32_t back = findEdge(target, idx);
+        setBit(traversableBack, e, back != CSR_NO_EDGE && canTravel(back));
+        if (back != CSR_NO_EDGE)
+            setBit(traversableBack, back, travel);
+    }
+
+    // Removes the node's link to target, the links after it shift down so the segment keeps its order
+    void removeEdge(uint32_t idx, uint32_t target)
+    {
+        uint32_t e = findEdge(idx, target);
+        if (e == CSR_NO_EDGE)
+            return;
+        for (uint32_t last = edgesEnd(idx) - 1; e < last; ++e)
+            copySlot(e + 1, e);
+        degrees[idx]--;
+        usedEdges--;
+    }
+
+    // Sets whether the node can travel to target, target's link back learns it too
+    void setTravel(uint32_t idx, uint32_t target, bool travel)
+    {
+        uint32_t e = findEdge(idx, target);
+        assert(e != CSR_NO_EDGE);
+        setBit(traversable, e, travel);
+        uint32_t back = findEdge(target, idx);
+        if (back != CSR_NO_EDGE)
+            setBit(traversableBack, back, travel);
+    }
+
+    inline void setWeight(uint32_t e, ll weight)
+    {
+        weights[e] = weight;
+    }
+
+    // Whether so many slots are unused that the segments should be packed back to back
+    inline bool needsCompaction() const
+    {
+        return garbageEdges > 1024 && garbageEdges > usedEdges;
+    }
+
+    // Packs every segment back to back in dense index order, each keeping just the room for its links
+    void compact()
+    {
+        std::vector<uint32_t> oldTargets;
+        std::vector<ll> oldWeights;
+        std::vector<uint64_t> oldTraversable, oldTraversableBack;
+        oldTargets.swap(targets);
+        oldWeights.swap(weights);
+        oldTraversable.swap(traversable);
+        oldTraversableBack.swap(traversableBack);
+
+        targets.assign(usedEdges, 0);
+        weights.assign(usedEdges, 0);
+        traversable.assign((usedEdges + 63) / 64, 0);
+        traversableBack.assign((usedEdges + 63) / 64, 0);
+
+        uint32_t total = 0;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (uint32_t k = 0; k < degrees[i]; ++k)
+            {
+                uint32_t from = offsets[i] + k;
+                targets[total + k] = oldTargets[from];
+                weights[total + k] = oldWeights[from];
+                setBit(traversable, total + k, getBit(oldTraversable, from));
+                setBit(traversableBack, total + k, getBit(oldTraversableBack, from));
+            }
+            offsets[i] = total;
+            capacity[i] = degrees[i];
+            total += degrees[i];
+        }
+        garbageEdges = 0;
+    }
+};
@@ -0,0 +1,335 @@
+/*
+deltaStepping.hpp
+    - Parallel delta-stepping single source shortest paths over the CSR link store on a work stealing pool
+    - Nodes are kept in buckets of delta wide weight ranges, a bucket's light links (weight <= delta) are relaxed in parallel until it stays empty, its heavy links once after
+    - Weights are atomic 64 bit values lowered with compare and swap, so any worker can relax any link
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "csr.hpp"
+#include "threadPool.hpp"
+
+#define DELTA_STEP_GRAIN 256 // Nodes a worker takes from a bucket at a time
+
+class DeltaStepping
+{
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    const GraphCSR &csr;
+    WorkStealingPool &pool;
+    ll delta; // Weight range of a bucket
+
+    std::unique_ptr<std::atomic<ll>[]> dist;      // <dense index, weight from start> (-1 if unreached)
+    std::unique_ptr<std::atomic<ll>[]> lightDone; // <dense index, weight the node's light links were last relaxed at> (-1 if never)
+    std::unique_ptr<std::atomic<ll>[]> heavyDone; // <dense index, weight the node's heavy links were relaxed at> (-1 if never)
+
+    // Written by one worker each and merged once a parallel pass is done
+    std::vector<std::vector<uint32_t>> lowered; // <worker, nodes whose weight the worker lowered>
+    std::vector<std::vector<uint32_t>> settled; // <worker, nodes the worker relaxed the heavy links of at their final weight>
+    std::vector<std::vector<uint32_t>> removed; // <worker, nodes the worker relaxed the light links of>
+
+    // Lowers the weight of idx to newWeight if it is smaller, returns whether it was
+    bool lower(uint32_t idx, ll newWeight)
+    {
+        ll old = dist[idx].load(std::memory_order_relaxed);
+        while (old == -1 || newWeight < old)
+        {
+            if (dist[idx].compare_exchange_weak(old, newWeight, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Relaxes the light or heavy links of a range of nodes
+    // Light passes skip entries left in a bucket the node has since moved out of and nodes already relaxed at their weight
+    class RelaxTask : public IRangeTask
+    {
+    private:
+        DeltaStepping &ds;
+
+    public:
+        const std::vector<uint32_t> *nodes;
+        bool heavy;
+        ll bucket; // Bucket being emptied, light passes only relax nodes still in it
+
+        RelaxTask(DeltaStepping &owner) : ds(owner), nodes(NULL), heavy(false), bucket(0) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = ds.csr;
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t idx = (*nodes)[i];
+                ll d = ds.dist[idx].load(std::memory_order_relaxed);
+                std::atomic<ll> &done = heavy ? ds.heavyDone[idx] : ds.lightDone[idx];
+                if ((!heavy && d / ds.delta != bucket) || done.exchange(d, std::memory_order_relaxed) == d)
+                    continue;
+                (heavy ? ds.settled : ds.removed)[worker].push_back(idx);
+
+                for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+                {
+                    if ((csr.weights[e] > ds.delta) != heavy || !csr.canTravel(e))
+                        continue;
+                    if (ds.lower(csr.targets[e], d + csr.weights[e]))
+                        ds.lowered[worker].push_back(csr.targets[e]);
+                }
+            }
+        }
+    };
+
+    // Marks the reached nodes a link of weight above 0 gives their weight, the serial queue holds them before it pops anything at that weight
+    class SeedTask : public IRangeTask
+    {
+    private:
+        DeltaStepping &ds;
+
+    public:
+        std::vector<uint8_t> *seeded;
+
+        SeedTask(DeltaStepping &owner) : ds(owner), seeded(NULL) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = ds.csr;
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                ll d = ds.dist[idx].load(std::memory_order_relaxed);
+                for (uint32_t e = csr.edgesBegin(idx); d > 0 && e < csr.edgesEnd(idx); ++e)
+                {
+                    ll fromDist = ds.dist[csr.targets[e]].load(std::memory_order_relaxed);
+                    if (csr.canTravelBack(e) && csr.weights[e] > 0 && fromDist != -1 && fromDist + csr.weights[e] == d)
+                    {
+                        (*seeded)[idx] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    };
+
+    // Picks each reached node's parent the way the serial queue does, the first node it pops that links to it at exactly the weight it is missing
+    class ParentTask : public IRangeTask
+    {
+    private:
+        DeltaStepping &ds;
+
+    public:
+        const std::vector<uint32_t> *rank; // <dense index, position in the serial queue's pop order>
+        std::vector<uint32_t> *parent;
+
+        ParentTask(DeltaStepping &owner) : ds(owner), rank(NULL), parent(NULL) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = ds.csr;
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                ll d = ds.dist[idx].load(std::memory_order_relaxed);
+                uint32_t best = NO_PARENT;
+                for (uint32_t e = csr.edgesBegin(idx); d != -1 && e < csr.edgesEnd(idx); ++e)
+                {
+                    uint32_t from = csr.targets[e];
+                    ll fromDist = ds.dist[from].load(std::memory_order_relaxed);
+                    if (!csr.canTravelBack(e) || fromDist == -1 || fromDist + csr.weights[e] != d || (*rank)[from] >= (*rank)[idx])
+                        continue;
+                    if (best == NO_PARENT || (*rank)[from] < (*rank)[best])
+                        best = from;
+                }
+                (*parent)[idx] = best;
+            }
+        }
+    };
+
+    // Moves the nodes workers lowered into the buckets of their new weight
+    // Returns the number of entries added
+    size_t fillBuckets(std::vector<std::vector<uint32_t>> &buckets)
+    {
+        size_t added = 0;
+        for (std::vector<uint32_t> &nodes : lowered)
+        {
+            for (uint32_t idx : nodes)
+                buckets[(dist[idx].load(std::memory_order_relaxed) / delta) % buckets.size()].push_back(idx);
+            added += nodes.size();
+            nodes.clear();
+        }
+        return added;
+    }
+
+    // Closest first, ties by index, so the order doesn't depend on how work was split
+    struct ByDist
+    {
+        const DeltaStepping *ds;
+        bool operator()(uint32_t a, uint32_t b) const
+        {
+            ll da = ds->dist[a].load(std::memory_order_relaxed);
+            ll db = ds->dist[b].load(std::memory_order_relaxed);
+            return da != db ? da < db : a < b;
+        }
+    };
+
+    // Reverse of ByDist, keeps the node that comes first on top of a heap
+    struct AfterByDist
+    {
+        const DeltaStepping *ds;
+        bool operator()(uint32_t a, uint32_t b) const
+        {
+            return ByDist{ds}(b, a);
+        }
+    };
+
+    // Reorders visitOrder (closest first, ties by index) into the order the serial queue pops the nodes and ranks them by it
+    // The queue pops ties lowest index first among the nodes it holds, but a node only reached through a link of weight 0
+    // is pushed once a node at its weight links to it, so it can pop after nodes with a higher index
+    // Serial, the heap only ever holds nodes reached through links of weight 0
+    void queueOrder(uint32_t start, std::vector<uint32_t> &visitOrder, std::vector<uint32_t> &rank)
+    {
+        size_t numNodes = csr.numNodes();
+        std::vector<uint8_t> seeded(numNodes, 0);
+        SeedTask seeds(*this);
+        seeds.seeded = &seeded;
+        pool.parallelFor(numNodes, DELTA_STEP_GRAIN, seeds);
+        seeded[start] = 1;
+        std::vector<uint8_t> queued(seeded); // <dense index, whether the queue got the node yet>
+
+        std::vector<uint32_t> byDist;
+        byDist.swap(visitOrder);
+        std::vector<uint32_t> zeroReached;
+        ByDist first{this};
+        AfterByDist after{this};
+        rank.assign(numNodes, UINT32_MAX);
+        size_t next = 0;
+        while (true)
+        {
+            while (next < byDist.size() && !seeded[byDist[next]])
+                next++;
+            if (next == byDist.size() && zeroReached.empty())
+                break;
+
+            uint32_t idx;
+            if (!zeroReached.empty() && (next == byDist.size() || first(zeroReached.front(), byDist[next])))
+            {
+                std::pop_heap(zeroReached.begin(), zeroReached.end(), after);
+                idx = zeroReached.back();
+                zeroReached.pop_back();
+            }
+            else
+            {
+                idx = byDist[next++];
+            }
+            rank[idx] = visitOrder.size();
+            visitOrder.push_back(idx);
+
+            ll d = dist[idx].load(std::memory_order_relaxed);
+            for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+            {
+                uint32_t to = csr.targets[e];
+                if (csr.weights[e] == 0 && csr.canTravel(e) && !queued[to] && dist[to].load(std::memory_order_relaxed) == d)
+                {
+                    queued[to] = 1;
+                    zeroReached.push_back(to);
+                    std::push_heap(zeroReached.begin(), zeroReached.end(), after);
+                }
+            }
+        }
+    }
+
+public:
+    // bucketDelta is the weight range of a bucket, at least 1
+    DeltaStepping(const GraphCSR &graphCSR, WorkStealingPool &workers, ll bucketDelta)
+        : csr(graphCSR), pool(workers), delta(std::max<ll>(1, bucketDelta)) {}
+
+    // Delta that keeps about one bucket's worth of light links per node, maxWeight over the average degree
+    static ll pickDelta(const GraphCSR &graphCSR, ll maxWeight)
+    {
+        size_t nodes = std::max<size_t>(1, graphCSR.numNodes());
+        ll avgDegree = std::max<ll>(1, graphCSR.numEdges() / nodes);
+        return std::max<ll>(1, maxWeight / avgDegree);
+    }
+
+    // Weights and parents from start, maxWeight has to bound every link weight
+    // Parents and visitOrder match Dijkstra on a DijkQueue, which pops ties lowest index first
+    // dist is -1 for unreached nodes and parent is NO_PARENT (UINT32_MAX) for the start and unreached nodes
+    void run(uint32_t start, ll maxWeight, std::vector<ll> &outDist, std::vector<uint32_t> &parent, std::vector<uint32_t> &visitOrder)
+    {
+        size_t numNodes = csr.numNodes();
+        dist.reset(new std::atomic<ll>[numNodes]);
+        lightDone.reset(new std::atomic<ll>[numNodes]);
+        heavyDone.reset(new std::atomic<ll>[numNodes]);
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            dist[i].store(-1, std::memory_order_relaxed);
+            lightDone[i].store(-1, std::memory_order_relaxed);
+            heavyDone[i].store(-1, std::memory_order_relaxed);
+        }
+        lowered.assign(pool.numWorkers(), std::vector<uint32_t>());
+        settled.assign(pool.numWorkers(), std::vector<uint32_t>());
+        removed.assign(pool.numWorkers(), std::vector<uint32_t>());
+        visitOrder.clear();
+
+        // Weights still queued lie within max link weight of the bucket being emptied, so the buckets are reused in a cycle
+        std::vector<std::vector<uint32_t>> buckets(std::max<ll>(0, maxWeight) / delta + 2);
+        dist[start].store(0, std::memory_order_relaxed);
+        buckets[0].push_back(start);
+        size_t queued = 1;
+
+        RelaxTask relax(*this);
+        std::vector<uint32_t> frontier; // Entries of the bucket taken for a light pass
+        std::vector<uint32_t> emptied;  // Nodes the bucket's light passes relaxed, their weights are final once the bucket stays empty
+        for (ll b = 0; queued > 0; ++b)
+        {
+            std::vector<uint32_t> &bucket = buckets[b % buckets.size()];
+            if (bucket.empty())
+                continue;
+
+            // Light links can lower nodes back into the bucket, it is emptied again until they stop
+            emptied.clear();
+            while (!bucket.empty())
+            {
+                frontier.clear();
+                frontier.swap(bucket);
+                queued -= frontier.size();
+
+                relax.nodes = &frontier;
+                relax.heavy = false;
+                relax.bucket = b;
+                pool.parallelFor(frontier.size(), DELTA_STEP_GRAIN, relax);
+                queued += fillBuckets(buckets);
+                for (std::vector<uint32_t> &nodes : removed)
+                {
+                    emptied.insert(emptied.end(), nodes.begin(), nodes.end());
+                    nodes.clear();
+                }
+            }
+
+            // Heavy links always land in a later bucket, relaxing them once at the final weights is enough
+            relax.nodes = &emptied;
+            relax.heavy = true;
+            pool.parallelFor(emptied.size(), DELTA_STEP_GRAIN, relax);
+            queued += fillBuckets(buckets);
+
+            size_t firstOfBucket = visitOrder.size();
+            for (std::vector<uint32_t> &nodes : settled)
+            {
+                visitOrder.insert(visitOrder.end(), nodes.begin(), nodes.end());
+                nodes.clear();
+            }
+            std::sort(visitOrder.begin() + firstOfBucket, visitOrder.end(), ByDist{this});
+        }
+
+        outDist.resize(numNodes);
+        for (size_t i = 0; i < numNodes; ++i)
+            outDist[i] = dist[i].load(std::memory_order_relaxed);
+
+        std::vector<uint32_t> rank;
+        queueOrder(start, visitOrder, rank);
+
+        parent.assign(numNodes, NO_PARENT);
+        ParentTask parents(*this);
+        parents.rank = &rank;
+        parents.parent = &parent;
+        pool.parallelFor(numNodes, DELTA_STEP_GRAIN, parents);
+    }
+};
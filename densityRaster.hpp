@@ -0,0 +1,155 @@
+/*
+densityRaster.hpp
+    - Coarsest level of detail, the whole graph drawn as one texture of how many links and nodes lie over each texel
+    - Built from the CSR link store only when the layout changes, drawing it is a single quad whatever the graph's size
+ */
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "csr.hpp"
+
+#define DENSITY_RASTER_SIZE 512                    // Texels along the longer side of the graph's bounds
+#define DENSITY_LINK_SAMPLES 64                    // Most texels a link is stepped through, longer links are sampled sparser
+#define DENSITY_LINK_COLOR sf::Color(255, 220, 60) // Texels only links cross
+#define DENSITY_NODE_COLOR sf::Color(90, 140, 255) // Texels holding node centers
+
+class DensityRaster
+{
+private:
+    sf::Texture texture;
+    sf::FloatRect bounds;             // World rect the texture covers
+    unsigned cols, rows;              // Texels across and down
+    float texelSize;                  // World units per texel
+    std::vector<uint32_t> linkCounts; // <texel, links crossing it>
+    std::vector<uint32_t> nodeCounts; // <texel, node centers in it>
+    std::vector<sf::Uint8> pixels;    // RGBA of every texel
+    size_t builtRevision;             // Layout revision the raster was built at
+    bool built;
+
+    inline unsigned texelOf(const sf::Vector2f &p) const
+    {
+        int tx = (int)((p.x - bounds.left) / texelSize);
+        int ty = (int)((p.y - bounds.top) / texelSize);
+        tx = tx < 0 ? 0 : (tx >= (int)cols ? cols - 1 : tx);
+        ty = ty < 0 ? 0 : (ty >= (int)rows ? rows - 1 : ty);
+        return ty * cols + tx;
+    }
+
+    // Counts the link once in every texel its samples land in, consecutive samples in the same texel count once
+    void addLink(const sf::Vector2f &a, const sf::Vector2f &b)
+    {
+        float span = std::max(std::fabs(b.x - a.x), std::fabs(b.y - a.y)) / texelSize;
+        unsigned steps = std::min<unsigned>(DENSITY_LINK_SAMPLES, (unsigned)std::ceil(span));
+        unsigned last = UINT32_MAX;
+        for (unsigned i = 0; i <= steps; ++i)
+        {
+            float t = steps > 0 ? (float)i / steps : 0.f;
+            unsigned texel = texelOf(a + (b - a) * t);
+            if (texel != last)
+                linkCounts[texel]++;
+            last = texel;
+        }
+    }
+
+    // Alpha of a count on a log scale up to the largest count, so sparse areas stay visible next to dense ones
+    static sf::Uint8 shade(uint32_t count, uint32_t maxCount, float minAlpha)
+    {
+        float level = std::log1p((float)count) / std::log1p((float)maxCount);
+        return (sf::Uint8)(minAlpha + (255.f - minAlpha) * level);
+    }
+
+public:
+    DensityRaster() : cols(0), rows(0), texelSize(1.f), builtRevision(0), built(false) {}
+
+    inline bool isBuiltAt(size_t revision) const
+    {
+        return built && builtRevision == revision;
+    }
+
+    // Counts every node and link of the store into texels over the nodes' bounds
+    void build(const GraphCSR &csr, size_t revision)
+    {
+        built = true;
+        builtRevision = revision;
+
+        bool any = false;
+        sf::Vector2f low, high;
+        for (uint32_t idx = 0; idx < csr.numNodes(); ++idx)
+        {
+            if (!csr.nodes[idx])
+                continue;
+            const sf::Vector2f &p = csr.positions[idx];
+            low = any ? sf::Vector2f(std::min(low.x, p.x), std::min(low.y, p.y)) : p;
+            high = any ? sf::Vector2f(std::max(high.x, p.x), std::max(high.y, p.y)) : p;
+            any = true;
+        }
+        if (!any)
+        {
+            cols = rows = 0;
+            return;
+        }
+
+        // Padded by a radius so nodes on the edge aren't cut in half
+        bounds = sf::FloatRect(low.x - NODE_RADIUS, low.y - NODE_RADIUS, high.x - low.x + 2 * NODE_RADIUS, high.y - low.y + 2 * NODE_RADIUS);
+        texelSize = std::max(bounds.width, bounds.height) / DENSITY_RASTER_SIZE;
+        cols = std::max(1u, (unsigned)std::ceil(bounds.width / texelSize));
+        rows = std::max(1u, (unsigned)std::ceil(bounds.height / texelSize));
+        linkCounts.assign((size_t)cols * rows, 0);
+        nodeCounts.assign((size_t)cols * rows, 0);
+
+        // Links are stored at both ends, each is counted from its lower index end
+        for (uint32_t idx = 0; idx < csr.numNodes(); ++idx)
+        {
+            if (!csr.nodes[idx])
+                continue;
+            nodeCounts[texelOf(csr.positions[idx])]++;
+            for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+            {
+                if (idx < csr.targets[e])
+                    addLink(csr.positions[idx], csr.positions[csr.targets[e]]);
+            }
+        }
+
+        uint32_t maxLinks = *std::max_element(linkCounts.begin(), linkCounts.end());
+        uint32_t maxNodes = *std::max_element(nodeCounts.begin(), nodeCounts.end());
+        pixels.assign((size_t)cols * rows * 4, 0);
+        for (size_t t = 0; t < linkCounts.size(); ++t)
+        {
+            sf::Color c = sf::Color::Transparent;
+            if (nodeCounts[t] > 0)
+            {
+                c = DENSITY_NODE_COLOR;
+                c.a = shade(nodeCounts[t], maxNodes, 120.f);
+            }
+            else if (linkCounts[t] > 0)
+            {
+                c = DENSITY_LINK_COLOR;
+                c.a = shade(linkCounts[t], maxLinks, 40.f);
+            }
+            pixels[4 * t] = c.r;
+            pixels[4 * t + 1] = c.g;
+            pixels[4 * t + 2] = c.b;
+            pixels[4 * t + 3] = c.a;
+        }
+
+        if (texture.getSize() != sf::Vector2u(cols, rows))
+            texture.create(cols, rows);
+        texture.update(pixels.data());
+    }
+
+    // Draws the raster over the graph's bounds in world space
+    void draw(sf::RenderTarget *win) const
+    {
+        if (cols == 0)
+            return;
+        sf::Vertex quad[4] = {
+            sf::Vertex(sf::Vector2f(bounds.left, bounds.top), sf::Vector2f(0.f, 0.f)),
+            sf::Vertex(sf::Vector2f(bounds.left + cols * texelSize, bounds.top), sf::Vector2f(cols, 0.f)),
+            sf::Vertex(sf::Vector2f(bounds.left + cols * texelSize, bounds.top + rows * texelSize), sf::Vector2f(cols, rows)),
+            sf::Vertex(sf::Vector2f(bounds.left, bounds.top + rows * texelSize), sf::Vector2f(0.f, rows))};
+        win->draw(quad, 4, sf::Quads, sf::RenderStates(&texture));
+    }
+};
@@ -0,0 +1,353 @@
+/*
+dijkQueue.hpp
+    - Monotone priority queues for Dijkstra over non-negative integer link weights
+    - Radix heap and Dial's bucket queue, plus a queue wrapper that picks one by the graph's max link weight
+    - Every queue pops equal keys lowest item first, so Dijkstra settles nodes in the same order whichever queue it runs with
+ */
+#pragma once
+#include <string>
+#include <algorithm>
+#include <functional>
+#include "heap.hpp"
+
+// Auto picks Dial's buckets when the max link weight is at most this, otherwise a radix heap
+#define DIAL_MAX_LINK_WEIGHT 1024
+
+enum class DijkQueueType
+{
+    Auto,
+    DaryHeap,
+    RadixHeap,
+    Dial
+};
+const std::string DijkQueueNames[] = {"Auto", "D-ary heap", "Radix heap", "Dial buckets"};
+
+// Keeps the current key of every item for queues that decrease keys lazily
+// Old entries are left in the buckets and skipped when they no longer match the item's key
+class LazyKeys
+{
+protected:
+    std::vector<ll> keys;        // <item, current key>
+    std::vector<uint8_t> queued; // <item, whether item is in the queue>
+    size_t live;                 // Number of items in the queue
+
+    LazyKeys() : live(0) {}
+
+    void fitItem(uint32_t item)
+    {
+        if (item >= keys.size())
+        {
+            keys.resize(item + 1, 0);
+            queued.resize(item + 1, 0);
+        }
+    }
+
+    // Whether a bucket entry still matches the item's current key
+    inline bool isLive(uint32_t item, ll key) const
+    {
+        return queued[item] && keys[item] == key;
+    }
+
+    // Records the new key of item, returns false if item is queued with a smaller or equal key
+    bool setKey(uint32_t item, ll key)
+    {
+        fitItem(item);
+        if (queued[item])
+        {
+            if (key >= keys[item])
+                return false;
+        }
+        else
+        {
+            queued[item] = 1;
+            live++;
+        }
+        keys[item] = key;
+        return true;
+    }
+
+    inline void unqueue(uint32_t item)
+    {
+        queued[item] = 0;
+        live--;
+    }
+
+public:
+    inline bool empty() const
+    {
+        return live == 0;
+    }
+
+    inline size_t size() const
+    {
+        return live;
+    }
+
+    inline bool contains(uint32_t item) const
+    {
+        return item < queued.size() && queued[item];
+    }
+};
+
+// Radix heap for monotone keys: every pushed key has to be >= the last popped key
+// Bucket i holds keys whose highest bit differing from the last popped key is bit i-1
+// Bucket 0 only holds the last popped key and is kept as a heap of items so the lowest pops first
+class RadixHeap : public LazyKeys
+{
+private:
+    typedef std::pair<uint32_t, ll> ENTRY; // <item, key when pushed>
+    static constexpr size_t NUM_BUCKETS = 65;
+
+    // Orders bucket 0's heap with the lowest item on top
+    struct LaterItem
+    {
+        bool operator()(const ENTRY &a, const ENTRY &b) const
+        {
+            return a.first > b.first;
+        }
+    };
+
+    std::vector<ENTRY> buckets[NUM_BUCKETS];
+    ll last; // Last popped key
+
+    inline size_t bucketIdx(ll key) const
+    {
+        unsigned long long diff = (unsigned long long)(key ^ last);
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+    }
+
+    // Moves the smallest live key into bucket 0 by redistributing the first non-empty bucket
+    void refill()
+    {
+        for (size_t i = 1; i < NUM_BUCKETS; ++i)
+        {
+            std::vector<ENTRY> &bucket = buckets[i];
+            if (bucket.empty())
+                continue;
+
+            // New last is the smallest live key in the bucket
+            bool found = false;
+            ll smallest = 0;
+            for (const ENTRY &e : bucket)
+            {
+                if (isLive(e.first, e.second) && (!found || e.second < smallest))
+                {
+                    smallest = e.second;
+                    found = true;
+                }
+            }
+
+            // Bucket only had stale entries
+            if (!found)
+            {
+                bucket.clear();
+                continue;
+            }
+
+            // Every live key in the bucket lands in a lower bucket relative to the new last
+            last = smallest;
+            for (const ENTRY &e : bucket)
+            {
+                if (isLive(e.first, e.second))
+                    buckets[bucketIdx(e.second)].push_back(e);
+            }
+            bucket.clear();
+            std::make_heap(buckets[0].begin(), buckets[0].end(), LaterItem());
+            return;
+        }
+    }
+
+public:
+    RadixHeap() : last(0) {}
+
+    // Inserts item, or lowers its key if it is already queued
+    bool push(uint32_t item, ll key)
+    {
+        assert(key >= last);
+        if (!setKey(item, key))
+            return false;
+        size_t b = bucketIdx(key);
+        buckets[b].push_back(ENTRY(item, key));
+        if (b == 0)
+            std::push_heap(buckets[0].begin(), buckets[0].end(), LaterItem());
+        return true;
+    }
+
+    // Removes and returns the item with the smallest key
+    uint32_t pop()
+    {
+        assert(!empty());
+        while (true)
+        {
+            if (buckets[0].empty())
+                refill();
+
+            std::pop_heap(buckets[0].begin(), buckets[0].end(), LaterItem());
+            ENTRY e = buckets[0].back();
+            buckets[0].pop_back();
+            if (isLive(e.first, e.second))
+            {
+                unqueue(e.first);
+                return e.first;
+            }
+        }
+    }
+};
+
+// Dial's bucket queue: a ring of maxWeight+1 buckets
+// Every queued key lies within [curr, curr + maxWeight] so each bucket only ever holds one live key
+// The bucket being popped is turned into a heap of items so the lowest pops first
+class DialQueue : public LazyKeys
+{
+private:
+    std::vector<std::vector<uint32_t>> buckets;
+    ll curr;   // Last popped key, smallest key that can still be queued
+    ll heaped; // Key whose bucket is a heap of items (-1 if none is)
+
+public:
+    DialQueue() : curr(0), heaped(-1)
+    {
+        setMaxWeight(0);
+    }
+
+    // Sets the largest link weight that can separate two queued keys, clears the queue
+    void setMaxWeight(ll maxWeight)
+    {
+        assert(maxWeight >= 0);
+        buckets.assign(maxWeight + 1, std::vector<uint32_t>());
+        keys.clear();
+        queued.clear();
+        live = 0;
+        curr = 0;
+        heaped = -1;
+    }
+
+    // Inserts item, or lowers its key if it is already queued
+    bool push(uint32_t item, ll key)
+    {
+        assert(key >= curr && key - curr < (ll)buckets.size());
+        if (!setKey(item, key))
+            return false;
+        std::vector<uint32_t> &bucket = buckets[key % buckets.size()];
+        bucket.push_back(item);
+        if (key == heaped)
+            std::push_heap(bucket.begin(), bucket.end(), std::greater<uint32_t>());
+        return true;
+    }
+
+    // Removes and returns the item with the smallest key
+    uint32_t pop()
+    {
+        assert(!empty());
+        while (true)
+        {
+            std::vector<uint32_t> &bucket = buckets[curr % buckets.size()];
+            if (heaped != curr)
+            {
+                std::make_heap(bucket.begin(), bucket.end(), std::greater<uint32_t>());
+                heaped = curr;
+            }
+            while (!bucket.empty())
+            {
+                std::pop_heap(bucket.begin(), bucket.end(), std::greater<uint32_t>());
+                uint32_t item = bucket.back();
+                bucket.pop_back();
+                if (isLive(item, curr))
+                {
+                    unqueue(item);
+                    return item;
+                }
+            }
+            curr++;
+        }
+    }
+};
+
+// Returns the queue Dijkstra should use for the requested type and graph max link weight
+inline DijkQueueType chooseDijkQueueType(const DijkQueueType requested, const ll maxLinkWeight)
+{
+    if (requested != DijkQueueType::Auto)
+        return requested;
+    return maxLinkWeight <= DIAL_MAX_LINK_WEIGHT ? DijkQueueType::Dial : DijkQueueType::RadixHeap;
+}
+
+// Priority queue used by Dijkstra, forwards to the d-ary heap, radix heap or Dial's buckets
+class DijkQueue
+{
+private:
+    DijkQueueType type;
+    IndexedHeap<4> heap;
+    RadixHeap radix;
+    DialQueue dial;
+
+public:
+    DijkQueue() : type(DijkQueueType::DaryHeap) {}
+
+    // Picks the queue implementation, should be set before anything is pushed
+    void setType(const DijkQueueType requested, const ll maxLinkWeight)
+    {
+        assert(empty());
+        type = chooseDijkQueueType(requested, maxLinkWeight);
+        if (type == DijkQueueType::Dial)
+            dial.setMaxWeight(maxLinkWeight);
+    }
+
+    inline DijkQueueType getType() const
+    {
+        return type;
+    }
+
+    // Inserts item, or lowers its key if it is already queued
+    // Returns false if item is already queued with a smaller or equal key
+    bool push(uint32_t item, ll key)
+    {
+        switch (type)
+        {
+        case DijkQueueType::RadixHeap:
+            return radix.push(item, key);
+        case DijkQueueType::Dial:
+            return dial.push(item, key);
+        default:
+            return heap.push(item, key);
+        }
+    }
+
+    uint32_t pop()
+    {
+        switch (type)
+        {
+        case DijkQueueType::RadixHeap:
+            return radix.pop();
+        case DijkQueueType::Dial:
+            return dial.pop();
+        default:
+            return heap.pop();
+        }
+    }
+
+    bool contains(uint32_t item) const
+    {
+        switch (type)
+        {
+        case DijkQueueType::RadixHeap:
+            return radix.contains(item);
+        case DijkQueueType::Dial:
+            return dial.contains(item);
+        default:
+            return heap.contains(item);
+        }
+    }
+
+    bool empty() const
+    {
+        switch (type)
+        {
+        case DijkQueueType::RadixHeap:
+            return radix.empty();
+        case DijkQueueType::Dial:
+            return dial.empty();
+        default:
+            return heap.empty();
+        }
+    }
+};
@@ -0,0 +1,323 @@
+/*
+directionBFS.hpp
+    - Parallel breadth first search over the CSR link store on a work stealing pool
+    - Levels are found top down from the frontier while it is small and bottom up from the unvisited nodes once it is big
+    - Visited nodes and bottom up frontiers are bitmaps, a bottom up worker owns whole words so only top down steps need atomics
+    - Parents and visit order matching the queue's are worked out afterwards, a level at a time
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include "csr.hpp"
+#include "threadPool.hpp"
+
+#define DIR_BFS_GRAIN 256 // Nodes, or bitmap words in bottom up steps, a worker takes at a time
+#define DIR_BFS_ALPHA 14  // Goes bottom up once the frontier has more links than the unvisited nodes over this
+#define DIR_BFS_BETA 24   // Goes back top down once a shrinking frontier has fewer nodes than all nodes over this
+
+class DirectionOptimizingBFS
+{
+public:
+    static constexpr uint32_t UNREACHED = UINT32_MAX; // Level of a node not reached
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+private:
+    const GraphCSR &csr;
+    WorkStealingPool &pool;
+    size_t words; // Bitmap words covering every dense index
+
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;      // Bit per dense index, set once the node has a level
+    std::unique_ptr<std::atomic<uint64_t>[]> frontier;     // Bit per dense index, set for the level being expanded bottom up
+    std::unique_ptr<std::atomic<uint64_t>[]> nextFrontier; // Bit per dense index, set for the level found bottom up
+    std::vector<uint32_t> *level;                          // <dense index, number of links from the start> (UNREACHED if not reached)
+
+    std::vector<uint32_t> order;    // Reached nodes level by level
+    std::vector<size_t> levelBegin; // <level, first of its nodes in order>, one past the last level ends order
+    std::vector<size_t> levelLinks; // <level, links of its nodes>
+
+    // Written by one worker each and merged once a level is done
+    std::vector<std::vector<uint32_t>> found; // <worker, nodes the worker gave the next level>
+    std::vector<size_t> foundLinks;           // <worker, links of the nodes in found>
+
+    // Parent pass state
+    std::unique_ptr<std::atomic<uint64_t>[]> firstLink; // <dense index, position of the first node linking to it in its level's order << 32 | the link's slot in that node>
+    std::vector<uint32_t> position;                     // <dense index, position in its level's order>
+
+    inline static uint64_t bitOf(uint32_t idx)
+    {
+        return 1ULL << (idx & 63);
+    }
+
+    // Gives the next level the unvisited nodes the level's nodes link to
+    class TopDownTask : public IRangeTask
+    {
+    private:
+        DirectionOptimizingBFS &bfs;
+
+    public:
+        const uint32_t *nodes;
+        uint32_t nextLevel;
+
+        TopDownTask(DirectionOptimizingBFS &owner) : bfs(owner), nodes(NULL), nextLevel(0) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = bfs.csr;
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t idx = nodes[i];
+                for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+                {
+                    uint32_t child = csr.targets[e];
+                    std::atomic<uint64_t> &word = bfs.visited[child >> 6];
+                    if (!csr.canTravel(e) || (word.load(std::memory_order_relaxed) & bitOf(child)) || (word.fetch_or(bitOf(child), std::memory_order_relaxed) & bitOf(child)))
+                        continue;
+                    (*bfs.level)[child] = nextLevel;
+                    bfs.found[worker].push_back(child);
+                    bfs.foundLinks[worker] += csr.degrees[child];
+                }
+            }
+        }
+    };
+
+    // Gives the next level the unvisited nodes linked from the frontier, a node stops looking at the first such link
+    // Ranges are bitmap words, each written only by the worker running it
+    class BottomUpTask : public IRangeTask
+    {
+    private:
+        DirectionOptimizingBFS &bfs;
+
+    public:
+        uint32_t nextLevel;
+
+        BottomUpTask(DirectionOptimizingBFS &owner) : bfs(owner), nextLevel(0) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = bfs.csr;
+            for (size_t w = begin; w < end; ++w)
+            {
+                uint64_t seen = bfs.visited[w].load(std::memory_order_relaxed);
+                uint64_t added = 0;
+                for (uint32_t idx = w << 6; idx < csr.numNodes() && idx < (w + 1) << 6; ++idx)
+                {
+                    if (seen & bitOf(idx))
+                        continue;
+                    for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+                    {
+                        uint32_t from = csr.targets[e];
+                        if (csr.canTravelBack(e) && (bfs.frontier[from >> 6].load(std::memory_order_relaxed) & bitOf(from)))
+                        {
+                            added |= bitOf(idx);
+                            (*bfs.level)[idx] = nextLevel;
+                            bfs.found[worker].push_back(idx);
+                            bfs.foundLinks[worker] += csr.degrees[idx];
+                            break;
+                        }
+                    }
+                }
+                bfs.nextFrontier[w].store(added, std::memory_order_relaxed);
+                if (added)
+                    bfs.visited[w].store(seen | added, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Finds the first link to each node of the next level from the level's nodes in their final order, the queue reaches it through that link
+    // Links are compared as <position in the level, slot in the node>
+    // Top down every link of the level is tried, nodes outside the next level are left at 0 so no link replaces theirs
+    // Bottom up each node of the next level picks the earliest of the level's nodes linking to it, then finds the link's slot in it
+    class FirstLinkTask : public IRangeTask
+    {
+    private:
+        DirectionOptimizingBFS &bfs;
+
+        inline static uint64_t linkOf(uint32_t position, uint32_t slot)
+        {
+            return ((uint64_t)position << 32) | slot;
+        }
+
+    public:
+        bool bottomUp;
+        const uint32_t *nodes; // The level's nodes in order top down, the next level's bottom up
+        uint32_t fromLevel;
+
+        FirstLinkTask(DirectionOptimizingBFS &owner) : bfs(owner), bottomUp(false), nodes(NULL), fromLevel(0) {}
+
+        void run(size_t begin, size_t end, unsigned worker) override
+        {
+            const GraphCSR &csr = bfs.csr;
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t idx = nodes[i];
+                if (!bottomUp)
+                {
+                    for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+                    {
+                        std::atomic<uint64_t> &first = bfs.firstLink[csr.targets[e]];
+                        uint64_t link = linkOf(i, e - csr.edgesBegin(idx));
+                        uint64_t old = first.load(std::memory_order_relaxed);
+                        while (link < old && csr.canTravel(e) && !first.compare_exchange_weak(old, link, std::memory_order_relaxed))
+                            ;
+                    }
+                    continue;
+                }
+
+                uint32_t from = NO_PARENT;
+                for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+                {
+                    uint32_t linked = csr.targets[e];
+                    if (csr.canTravelBack(e) && (*bfs.level)[linked] == fromLevel && (from == NO_PARENT || bfs.position[linked] < bfs.position[from]))
+                        from = linked;
+                }
+                for (uint32_t e = csr.edgesBegin(from); e < csr.edgesEnd(from); ++e)
+                {
+                    if (csr.targets[e] == idx && csr.canTravel(e))
+                    {
+                        bfs.firstLink[idx].store(linkOf(bfs.position[from], e - csr.edgesBegin(from)), std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+        }
+    };
+
+    // Appends the nodes workers found to order as the next level, returns how many and sums their links into links
+    size_t mergeFound(size_t &links)
+    {
+        size_t added = 0;
+        links = 0;
+        for (size_t w = 0; w < found.size(); ++w)
+        {
+            order.insert(order.end(), found[w].begin(), found[w].end());
+            added += found[w].size();
+            links += foundLinks[w];
+            found[w].clear();
+            foundLinks[w] = 0;
+        }
+        levelBegin.push_back(order.size());
+        levelLinks.push_back(links);
+        return added;
+    }
+
+public:
+    DirectionOptimizingBFS(const GraphCSR &graphCSR, WorkStealingPool &workers) : csr(graphCSR), pool(workers), words(0), level(NULL) {}
+
+    // Number of links from start to every node it reaches
+    // Stops one level past the level holding stop so parents can match a queue that stops there, UNREACHED runs through
+    void run(uint32_t start, uint32_t stop, std::vector<uint32_t> &outLevel)
+    {
+        size_t numNodes = csr.numNodes();
+        words = (numNodes + 63) / 64;
+        visited.reset(new std::atomic<uint64_t>[words]);
+        frontier.reset(new std::atomic<uint64_t>[words]);
+        nextFrontier.reset(new std::atomic<uint64_t>[words]);
+        for (size_t w = 0; w < words; ++w)
+            visited[w].store(0, std::memory_order_relaxed);
+        found.assign(pool.numWorkers(), std::vector<uint32_t>());
+        foundLinks.assign(pool.numWorkers(), 0);
+
+        level = &outLevel;
+        level->assign(numNodes, UNREACHED);
+        (*level)[start] = 0;
+        visited[start >> 6].store(bitOf(start), std::memory_order_relaxed);
+        order.assign(1, start);
+        levelBegin.assign(1, 0);
+        levelBegin.push_back(1);
+        levelLinks.assign(1, csr.degrees[start]);
+
+        TopDownTask topDown(*this);
+        BottomUpTask bottomUp(*this);
+        bool isBottomUp = false;
+        size_t frontierNodes = 1;
+        size_t frontierLinks = csr.degrees[start];
+        size_t unvisitedLinks = csr.numEdges() - frontierLinks;
+        for (uint32_t l = 0; frontierNodes > 0 && (stop == UNREACHED || (*level)[stop] == UNREACHED || l <= (*level)[stop]); ++l)
+        {
+            // Bottom up pays off once looking from the unvisited nodes touches fewer links than expanding the frontier
+            size_t prevNodes = l > 0 ? levelBegin[l] - levelBegin[l - 1] : 0;
+            if (!isBottomUp && frontierLinks > unvisitedLinks / DIR_BFS_ALPHA)
+            {
+                isBottomUp = true;
+                for (size_t w = 0; w < words; ++w)
+                    frontier[w].store(0, std::memory_order_relaxed);
+                for (size_t i = levelBegin[l]; i < levelBegin[l + 1]; ++i)
+                    frontier[order[i] >> 6].fetch_or(bitOf(order[i]), std::memory_order_relaxed);
+            }
+            else if (isBottomUp && frontierNodes < numNodes / DIR_BFS_BETA && frontierNodes < prevNodes)
+                isBottomUp = false;
+
+            if (isBottomUp)
+            {
+                bottomUp.nextLevel = l + 1;
+                pool.parallelFor(words, DIR_BFS_GRAIN / 64, bottomUp);
+                frontier.swap(nextFrontier);
+            }
+            else
+            {
+                topDown.nodes = order.data() + levelBegin[l];
+                topDown.nextLevel = l + 1;
+                pool.parallelFor(frontierNodes, DIR_BFS_GRAIN, topDown);
+            }
+
+            frontierNodes = mergeFound(frontierLinks);
+            unvisitedLinks -= std::min(unvisitedLinks, frontierLinks);
+        }
+
+        // A level left empty by the last step isn't a level
+        if (levelBegin.back() == levelBegin[levelBegin.size() - 2])
+        {
+            levelBegin.pop_back();
+            levelLinks.pop_back();
+        }
+    }
+
+    // Parents and visit order a queue would give the levels of the last run, parent is NO_PARENT for the start and unreached nodes
+    // Each node takes the first node of the level before it to link to it, in the order that level was visited
+    void parents(std::vector<uint32_t> &parent, std::vector<uint32_t> &visitOrder)
+    {
+        assert(level && "Levels have to be run first");
+        size_t numNodes = csr.numNodes();
+        parent.assign(numNodes, NO_PARENT);
+        visitOrder = order;
+        firstLink.reset(new std::atomic<uint64_t>[numNodes]);
+        for (size_t i = 0; i < numNodes; ++i)
+            firstLink[i].store(0, std::memory_order_relaxed);
+        position.assign(numNodes, 0);
+
+        FirstLinkTask firstLinks(*this);
+        std::vector<std::pair<uint64_t, uint32_t>> next; // <first link, node> of the next level
+        for (size_t l = 0; l + 2 < levelBegin.size(); ++l)
+        {
+            uint32_t *nodes = visitOrder.data() + levelBegin[l];
+            uint32_t *nextNodes = visitOrder.data() + levelBegin[l + 1];
+            size_t numNext = levelBegin[l + 2] - levelBegin[l + 1];
+            for (size_t i = 0; i < numNext; ++i)
+                firstLink[nextNodes[i]].store(UINT64_MAX, std::memory_order_relaxed);
+
+            // A next level with few links is cheaper to look at from its own nodes, as near the end of the search
+            firstLinks.bottomUp = 2 * levelLinks[l + 1] < levelLinks[l];
+            firstLinks.nodes = firstLinks.bottomUp ? nextNodes : nodes;
+            firstLinks.fromLevel = l;
+            pool.parallelFor(firstLinks.bottomUp ? numNext : levelBegin[l + 1] - levelBegin[l], DIR_BFS_GRAIN, firstLinks);
+
+            // The queue visits children in the order their parents were visited, then in the order of the parent's links
+            next.clear();
+            for (size_t i = 0; i < numNext; ++i)
+            {
+                next.push_back(std::make_pair(firstLink[nextNodes[i]].load(std::memory_order_relaxed), nextNodes[i]));
+                firstLink[nextNodes[i]].store(0, std::memory_order_relaxed);
+            }
+            std::sort(next.begin(), next.end());
+            for (size_t i = 0; i < numNext; ++i)
+            {
+                nextNodes[i] = next[i].second;
+                parent[next[i].second] = nodes[next[i].first >> 32];
+                position[next[i].second] = i;
+            }
+        }
+    }
+};
@@ -6,8 +6,11 @@ Graph class:
     - handle deletion of a Node (what happens to its links)
 */
 #pragma once
+// DIJK_HEADLESS builds the graph without imgui (benchmarks), drawGraphViewer is left out
+#ifndef DIJK_HEADLESS
 #include "imgui.h"
 #include "imgui-SFML.h"
+#endif
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <cstdlib>
@@ -18,10 +21,18 @@ Graph class:
 #include <string>
 #include <math.h>
 #include <utility>
+#include <algorithm>
 
 #include "node.hpp"
+#include "csr.hpp"
+#include "slotmap.hpp"
+#include "components.hpp"
+#include "connectivity.hpp"
+#include "spatialGrid.hpp"
+#include "graphTraversal.hpp"
+#include "densityRaster.hpp"
 
-typedef std::tuple<Node *, ll, ll, bool> ADJ_NODE; //(tuple: curr node, link weight, link identifier, link type (can main node access curr node))
+#define GRAPH_WORLD_SIZE (1 << 20) // Width and height of the world space nodes are placed in, the interface shows part of it through a camera
 
 class Graph
 {
@@ -31,20 +42,85 @@ private:
     size_t num_graphs;                        // keeps track of the total number of graphs
     ll curr_node_ident;                       // used to create a new unique node identifier
     ll curr_link_ident;                       // used to create a new unique link identifier
+    ll max_link_weight;                       // largest weight a link has been given (upper bound, not lowered when links are removed)
+    double min_weight_per_pixel;              // smallest link weight per pixel of link length (lower bound, not raised when links are removed or shortened)
     std::vector<Node *> all_graphs;           // vector containing all graphs
     std::vector<size_t> open_locs;            // Keeps track of indices in all_graphs that are null
-    std::unordered_map<ll, size_t> node_locs; //<Node identifier, all_graphs index> Keeps track of a nodes location in all_graphs
+    GraphComponents node_locs;                //<Node dense index, all_graphs index> Keeps track of a nodes location in all_graphs
+    DynamicConnectivity node_conns;           // Tells whether removing a link splits a graph without traversing it
     // UPDATING
     //  Node** node_ilocs;                                              //Keeps track of the location of each node in the window interface
-    std::unordered_map<size_t, Node *> node_wlocs; // Better version of keeping track of each node in the window interface
+    std::unordered_map<uint64_t, Node *> node_wlocs; // <world position key, node centered there> Better version of keeping track of each node in the window interface
+    SpatialGrid node_grid;                           // Buckets node centers for finding the nodes around a point or in view
+    std::vector<Node *> move_near;                   // Nodes around the position moveNode is moving a node to
+    NodeSlots node_slots;                            // <Node identifier, dense index> Dense indices are reused by new nodes
+
+    // Every link of the graphs by dense index, the only place links are kept, the traversal engines read it directly
+    GraphCSR csr;
+    size_t version;                    // Bumped by every change to the nodes or links, tells precomputed data (landmarks) it is stale
+    size_t moves;                      // Bumped by every node move, which leaves version alone since no weights change
 
     Links GUIlinks; // Lines used to represent links between nodes on the interface
+    GraphTraversal traversal; // Depth first traversal reused by drawing, listing, searching and erasing a graph
+    NodeVisuals node_visuals; // Look of every node on the interface by dense index
+    std::vector<Node *> visible_nodes; // Nodes drawNodesIn found in view
+    std::vector<uint32_t> visible_idx; // Dense indices of visible_nodes in drawing order
+    DensityRaster density;             // Whole graph as one texture for the coarsest level of detail
+
+    // Draws every node it visits
+    class DrawVisitor : public INodeVisitor
+    {
+    public:
+        sf::RenderWindow *win;
+
+        DrawVisitor(sf::RenderWindow *window) : win(window) {}
+
+        bool visit(Node *n) override
+        {
+            n->drawNode(win);
+            return true;
+        }
+    };
+
+    // Appends the identifier of every node it visits to text, separated by spaces
+    class RecordVisitor : public INodeVisitor
+    {
+    public:
+        std::string &text;
+        bool first;
+
+        RecordVisitor(std::string &out) : text(out), first(true) {}
+
+        bool visit(Node *n) override
+        {
+            if (!first)
+                text += ' ';
+            text += std::to_string(n->getNodeIdent());
+            first = false;
+            return true;
+        }
+    };
+
+    // Collects every node it visits
+    class CollectVisitor : public INodeVisitor
+    {
+    public:
+        std::vector<Node *> &nodes;
+
+        CollectVisitor(std::vector<Node *> &out) : nodes(out) {}
+
+        bool visit(Node *n) override
+        {
+            nodes.push_back(n);
+            return true;
+        }
+    };
     // NOT YET IMPLEMENTED: Keeps track of open cells in all_graphs (might implement later - to deal with all_graphs space usage)
     // std::unordered_set<size_t> open_locs;
 public:
-    Graph() : curr_node_ident(0), curr_link_ident(0), num_graphs(0) {};
+    Graph() : curr_node_ident(0), curr_link_ident(0), max_link_weight(0), min_weight_per_pixel(INFINITY), num_graphs(0), version(0), moves(0) {};
 
-    Graph(const int &w_width, const int &w_height, const int &s_width, const int &s_height) : curr_node_ident(0), curr_link_ident(0), num_graphs(0)
+    Graph(const int &w_width, const int &w_height, const int &s_width, const int &s_height) : curr_node_ident(0), curr_link_ident(0), max_link_weight(0), min_weight_per_pixel(INFINITY), num_graphs(0), version(0), moves(0)
     {
         // initialize node interface location array
         size_t i_size = s_width * s_height;
@@ -72,29 +148,50 @@ public:
             - Drawing graph viewing table
     */
 
-    // Draws all links
-    inline void drawAllLinks(sf::RenderWindow *win)
+    // Draws the links crossing the world rect, with arrows and weights if detailed
+    inline void drawLinksIn(sf::RenderTarget *win, const sf::FloatRect &rect, bool detailed)
     {
-        GUIlinks.drawLinks(win);
+        GUIlinks.drawLinks(win, rect, detailed);
     }
 
-    // helper of function drawAllNodesinGraph
-    // Runs DFS on graph to draw each node in the given graph
-    void DFSGraphDraw(Node *curr, std::unordered_set<ll> &visited, sf::RenderWindow *win)
+    // draws the nodes of every graph whose circle overlaps the world rect, in dense index order
+    void drawNodesIn(sf::RenderTarget *win, const sf::FloatRect &rect, NodeDetail detail)
     {
-        visited.insert(curr->getNodeIdent());
-        curr->drawNode(win);
+        float pad = NODE_RADIUS + NODE_OUTLINE_THICKNESS;
+        visible_nodes.clear();
+        node_grid.queryRect(sf::FloatRect(rect.left - pad, rect.top - pad, rect.width + 2 * pad, rect.height + 2 * pad), visible_nodes);
+
+        visible_idx.clear();
+        for (Node *n : visible_nodes)
+            visible_idx.push_back(n->getNodeIdx());
+        std::sort(visible_idx.begin(), visible_idx.end());
+        node_visuals.drawSome(visible_idx, win, detail);
+    }
 
-        // inspect current node's links if they aren't already visited
-        std::vector<ADJ_NODE> links = curr->getNodeLinks();
-        for (size_t i = 0; i < links.size(); ++i)
-        {
-            Node *inspect = std::get<0>(links[i]);
-            if (!visited.count(inspect->getNodeIdent()))
-            {
-                DFSGraphDraw(inspect, visited, win);
-            }
-        }
+    // draws every node and link as the density raster, rebuilt from the CSR link store if the layout changed since
+    void drawDensity(sf::RenderTarget *win)
+    {
+        size_t revision = getLayoutRevision();
+        if (!density.isBuiltAt(revision))
+            density.build(buildCSR(), revision);
+        density.draw(win);
+    }
+
+    // Changes whenever a node or link is added, removed or moved
+    inline size_t getLayoutRevision() const
+    {
+        return version + moves;
+    }
+
+    inline size_t getNumNodes() const
+    {
+        return node_wlocs.size();
+    }
+
+    // Changes whenever anything drawLinksIn or drawNodesIn draws does, so a cached drawing of the graph knows when it is stale
+    inline size_t getSceneRevision() const
+    {
+        return GUIlinks.getRevision() + node_visuals.getRevision();
     }
 
     // draws all nodes in a given graph index
@@ -103,52 +200,39 @@ public:
         Node *node_head = all_graphs[graph_idx];
         if (node_head)
         {
-            std::unordered_set<ll> visited;
-            DFSGraphDraw(node_head, visited, win);
+            DrawVisitor draw(win);
+            traversal.depthFirst(csr, node_head, draw);
         }
     }
 
     // record nodes at a certain graph position to IMGUI graph table
-    void recordAllNodes(Node *curr, std::unordered_set<ll> &visited, std::string &allnodes)
+    void recordAllNodes(Node *graph_head, std::string &allnodes)
     {
-        ll currNode = curr->getNodeIdent();
-        visited.insert(currNode);
-        allnodes += std::to_string(currNode);
-
-        std::vector<ADJ_NODE> links = curr->getNodeLinks();
-        for (size_t i = 0; i < links.size(); ++i)
-        {
-            Node *inspect = std::get<0>(links[i]);
-            if (!visited.count(inspect->getNodeIdent()))
-            {
-                allnodes += ' ';
-                recordAllNodes(inspect, visited, allnodes);
-            }
-        }
+        RecordVisitor record(allnodes);
+        traversal.depthFirst(csr, graph_head, record);
     }
 
+#ifndef DIJK_HEADLESS
     // render IMGUI table to display nodes corresponding to each graph
     void drawGraphViewer()
     {
         for (size_t i = 0; i < all_graphs.size(); ++i)
         {
-            std::unordered_set<ll> visited;
             std::string allnodes = "\t";
 
             ImGui::Text("Graph: %d", i);
             if (all_graphs[i])
             {
-                recordAllNodes(all_graphs[i], visited, allnodes);
+                recordAllNodes(all_graphs[i], allnodes);
                 ImGui::Text(allnodes.c_str());
             }
             else
             {
                 ImGui::Text(" ");
             }
-
-            visited.clear();
         }
     }
+#endif
 
     // //determines if it's legal to move node to a new position
     // void moveNode(Node* node, sf::Vector2f& oldpos, sf::Vector2f& newpos){
@@ -282,8 +366,9 @@ public:
     // checks if a node exists and returns the position of a node in all_graphs
     inline size_t getNodeGraphsPos(ll ident)
     {
-        if (node_locs.count(ident))
-            return node_locs[ident];
+        Node *n = findNode(ident);
+        if (n)
+            return node_locs.getLoc(n->getNodeIdx());
         else
             return -1;
     }
@@ -312,14 +397,62 @@ public:
         return num_graphs;
     }
 
+    // returns an upper bound on every link weight in the graphs
+    inline ll getMaxLinkWeight() const
+    {
+        return max_link_weight;
+    }
+
+    // returns the number of changes made to the nodes and links so far
+    inline size_t getVersion() const
+    {
+        return version;
+    }
+
+    // returns a lower bound on every link's weight divided by its length in pixels (0 if no link was made)
+    inline double getMinWeightPerPixel() const
+    {
+        return std::isinf(min_weight_per_pixel) ? 0 : min_weight_per_pixel;
+    }
+
+    // lowers the min weight per pixel if the link between n1 and n2 has less weight per pixel
+    void updateMinWeightPerPixel(Node *n1, Node *n2, const ll &link_weight)
+    {
+        sf::Vector2f d = n1->getNodePos() - n2->getNodePos();
+        double length = std::sqrt((double)d.x * d.x + (double)d.y * d.y);
+        if (length > 0 && link_weight / length < min_weight_per_pixel)
+            min_weight_per_pixel = link_weight / length;
+    }
+
     // returns the node interface location array
     //  inline Node** getNodeIlocs(){
     //      return node_ilocs;
     //  }
 
+    // returns the link store of all graphs, packed first if too many of its edge slots are unused
+    // the store changes under any call that creates, links, unlinks or deletes nodes
+    const GraphCSR &buildCSR()
+    {
+        if (csr.needsCompaction())
+            csr.compact();
+        return csr;
+    }
+
+    // Key of a world position in node_wlocs
+    inline static uint64_t worldKey(const sf::Vector2i &pos)
+    {
+        return ((uint64_t)(uint32_t)pos.y << 32) | (uint32_t)pos.x;
+    }
+
+    // Whether a node centered at pos lies fully inside the world
+    inline static bool inWorld(const sf::Vector2i &pos)
+    {
+        return pos.x - NODE_RADIUS >= 0 && pos.y - NODE_RADIUS >= 0 && pos.x + NODE_RADIUS <= GRAPH_WORLD_SIZE && pos.y + NODE_RADIUS <= GRAPH_WORLD_SIZE;
+    }
+
     Node *getNodeAtPosition(const sf::Vector2i &pos)
     {
-        int node_pos = simul_width * pos.y + pos.x;
+        uint64_t node_pos = worldKey(pos);
         if (node_wlocs.count(node_pos))
         {
             return node_wlocs[node_pos];
@@ -327,7 +460,7 @@ public:
         return NULL;
     }
 
-    Node *getNodeAtPosition(const size_t &node_pos)
+    Node *getNodeAtPosition(const uint64_t &node_pos)
     {
         if (node_wlocs.count(node_pos))
         {
@@ -336,93 +469,43 @@ public:
         return NULL;
     }
 
-    // Runs a depth first search on the graph to find node with the given identifier (Returns NULL if node was not in the graph)
-    Node *graphDFS(Node *curr, ll ident, std::unordered_set<ll> &visited)
+    // appends the nodes whose center lies in the square of the given radius around pos
+    inline void getNodesNear(const sf::Vector2i &pos, size_t radius, std::vector<Node *> &out) const
     {
-        std::cout << "Curr node: " << curr->getNodeIdent() << '\n';
-        if (curr->getNodeIdent() == ident)
-        {
-            std::cout << "DFS found: " << curr->getNodeIdent() << " == " << ident << '\n';
-            return curr;
-        }
-        else
-        {
-            // mark current node as visited
-            visited.insert(curr->getNodeIdent());
-            // get the current nodes links
-            std::vector<ADJ_NODE> links = curr->getNodeLinks();
-
-            // search for the next unvisited node in the current nodes links vector
-            for (size_t i = 0; i < links.size(); ++i)
-            {
-                Node *inspect = std::get<0>(links[i]);
-                Node *retval = NULL;
-
-                std::cout << "\tCN: " << curr->getNodeIdent() << " searching link: " << inspect->getNodeIdent() << '\n';
-                if (!visited.count(inspect->getNodeIdent()))
-                {
-                    std::cout << "\tCN: " << curr->getNodeIdent() << " inspecting link: " << inspect->getNodeIdent() << '\n';
-                    retval = graphDFS(inspect, ident, visited);
-                    if (retval)
-                        return retval;
-                }
-
-                std::cout << "\tCN: " << curr->getNodeIdent() << " leaving link: " << inspect->getNodeIdent() << '\n';
-            }
-        }
-
-        // Couldn't find node with identity so return null adj_node
-        return NULL;
+        node_grid.query(pos, radius, out);
     }
 
-    // finds a given node in one of the graphs and the node identifier
-    // should only take ident as parameter
+    // finds a given node in one of the graphs in constant time (Returns NULL if node was not in the graph)
     Node *findNode(size_t graph_index, ll ident)
     {
-        std::unordered_set<ll> visited;
-        // write a map that determines which index in all_graphs the indentifier belongs to
-        return graphDFS(all_graphs[graph_index], ident, visited);
+        Node *found = findNode(ident);
+        if (found && node_locs.getLoc(found->getNodeIdx()) != graph_index)
+            return NULL;
+        return found;
     }
 
-    // runs DFS to find node with given identifier
-    // REVISED: you don't have to tell which all_graphs index to look into
-    Node *findNode(ll ident)
+    // returns the node with the given identifier in constant time (Returns NULL if the node doesn't exist or was deleted)
+    inline Node *findNode(ll ident) const
     {
-        std::cout << "\nFINDING NODE" << ident << "\n";
-        if (!node_locs.count(ident))
-        {
-            std::cout << "\tERROR in graph.REVISEDfindNode - Node location not recorded in map - EXITING\n";
-            exit(EXIT_FAILURE);
-        }
-
-        Node *findNode = all_graphs[node_locs[ident]];
-        if (findNode == NULL)
-        {
-            std::cout << "\tREVISEDfindNode: Error - node to find is not in all_graphs\n";
-            std::cout << "\t Searching for node: " << ident;
-            std::cout << "\n\t Searched for index: " << node_locs[ident] << " in all_graphs - EXITING\n";
-            exit(EXIT_FAILURE);
-        }
-        else
-        {
-            std::cout << "\tNode found in location: " << node_locs[ident] << "\n";
-        }
-
-        std::unordered_set<ll> visited;
-        Node *ret = graphDFS(findNode, ident, visited);
-        if (ret == NULL)
-            std::cout << "\tDFS returned nll\n";
-        return ret;
+        return node_slots.find(ident);
     }
 
     // creates a new individual node and implants it as its own graph at position pos
     void createNewNode(sf::Vector2i pos, sf::Font &font)
     {
-        // Node created within simul bounds
-        if (pos.x - NODE_RADIUS >= 0 && pos.y - NODE_RADIUS >= 0 && pos.x + NODE_RADIUS <= simul_width && pos.y + NODE_RADIUS <= simul_height)
+        // Node created within world bounds
+        if (inWorld(pos))
         {
             ll ident = getNewNodeIdent();
-            Node *nn = new Node(ident, sf::Vector2f(pos), font);
+            Node *nn = new Node(ident, sf::Vector2f(pos));
+
+            // give the node a dense index, reusing indices of deleted nodes
+            uint32_t idx = node_slots.insert(ident, nn);
+            nn->setNodeIdx(idx);
+            node_visuals.add(idx, std::to_string(ident), sf::Vector2f(pos), font);
+            nn->setVisuals(&node_visuals);
+            csr.addNode(nn);
+            version++;
 
             // determine where to place the new node in all_graphs
             size_t open_idx = all_graphs.size();
@@ -437,11 +520,12 @@ public:
                 all_graphs.push_back(nn);
             }
 
-            // store mapping from identity to all_graphs index
-            node_locs[ident] = open_idx;
+            // store mapping from dense index to all_graphs index
+            node_locs.addNode(idx, open_idx);
+            node_conns.addVertex(idx);
 
             // set the node in the interface array
-            size_t iloc = simul_width * pos.y + pos.x;
+            uint64_t iloc = worldKey(pos);
             // UPDATING:
             // if (node_ilocs[iloc] == NULL){
             //     node_ilocs[iloc] = nn;
@@ -454,6 +538,7 @@ public:
                 // node_wlocs.insert(std::make_pair<size_t,Node*>(iloc, nn));
                 node_wlocs.insert({iloc, nn});
                 // node_wlocs[iloc] = nn;
+                node_grid.insert(nn, pos);
             }
             else
             {
@@ -477,6 +562,57 @@ public:
         std::cout << "\n";
     }
 
+    // moves a node to a new position inside the world bounds
+    // returns false if the position is out of bounds or another node is as close as a new node could be placed
+    bool moveNode(Node *n, const sf::Vector2i &pos)
+    {
+        if (!inWorld(pos))
+            return false;
+
+        sf::Vector2i oldPos = sf::Vector2i(n->getNodePos());
+        uint64_t oldIloc = worldKey(oldPos);
+        uint64_t iloc = worldKey(pos);
+        if (iloc == oldIloc)
+            return true;
+
+        // same spacing the interface keeps when adding a node, the moving node doesn't block itself
+        move_near.clear();
+        node_grid.query(pos, NODE_RADIUS * 4, move_near);
+        for (Node *other : move_near)
+        {
+            if (other != n)
+                return false;
+        }
+
+        // update the node's interface position and spatial index
+        node_wlocs.erase(oldIloc);
+        node_wlocs.insert({iloc, n});
+        node_grid.move(n, oldPos, pos);
+        n->setNodePos(pos);
+        moves++;
+        csr.setPosition(n->getNodeIdx(), sf::Vector2f(pos));
+
+        // redraw the node's links from its new position, a lengthened link can lower the weight per pixel
+        ll ident = n->getNodeIdent();
+        uint32_t idx = n->getNodeIdx();
+        for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+        {
+            Node *other = csr.nodes[csr.targets[e]];
+            ll otherIdent = other->getNodeIdent();
+            ll weight = csr.weights[e];
+            updateMinWeightPerPixel(n, other, weight);
+
+            GUIlinks.removeLink(ident, otherIdent);
+            if (!csr.canTravelBack(e))
+                GUIlinks.addLink(n->getNodePos(), other->getNodePos(), ident, otherIdent, weight, LinkStat::SinglyTo);
+            else if (!csr.canTravel(e))
+                GUIlinks.addLink(other->getNodePos(), n->getNodePos(), otherIdent, ident, weight, LinkStat::SinglyTo);
+            else
+                GUIlinks.addLink(n->getNodePos(), other->getNodePos(), ident, otherIdent, weight, LinkStat::Doubly);
+        }
+        return true;
+    }
+
     /*
         - Joining Nodes
         - Unjoining Nodes
@@ -594,38 +730,29 @@ public:
     {
         ll n1Ident = n1->getNodeIdent();
         ll n2Ident = n2->getNodeIdent();
-        size_t loc1 = node_locs[n1Ident];
-        size_t loc2 = node_locs[n2Ident];
+        size_t loc1 = node_locs.getLoc(n1->getNodeIdx());
+        size_t loc2 = node_locs.getLoc(n2->getNodeIdx());
+
+        // record max link weight for picking dijkstra's queue and weight per pixel for A*'s heuristic
+        if (link_weight > max_link_weight)
+            max_link_weight = link_weight;
+        updateMinWeightPerPixel(n1, n2, link_weight);
 
         // update node 2's node_loc to be the same as node 1 if it isn't already
         if (loc1 != loc2)
         {
-            std::unordered_set<ll> visited;
-            // update node_locs map for the graph thats getting moved
-            moveGraphLoc(all_graphs[loc2], visited, loc1);
+            // merging the sets moves all of node 2's graph to loc1
+            node_locs.merge(n1->getNodeIdx(), n2->getNodeIdx());
             all_graphs[loc2] = NULL;
             open_locs.push_back(loc2);
             num_graphs--;
         }
 
         // Check to see link status between both nodes
-        bool alreadyConnected = 0;
-        bool n1_con;
-        ll currLinkWeight = 0;
-        std::vector<ADJ_NODE> links = n1->getNodeLinks();
-        size_t n1_l_idx;
-        for (size_t i = 0; i < links.size(); ++i)
-        {
-            Node *check = std::get<0>(links[i]);
-            if (check->getNodeIdent() == n2->getNodeIdent())
-            {
-                alreadyConnected = 1;
-                n1_l_idx = i;
-                n1_con = std::get<3>(links[i]);
-                currLinkWeight = std::get<1>(links[i]);
-                break;
-            }
-        }
+        uint32_t n1Idx = n1->getNodeIdx();
+        uint32_t n2Idx = n2->getNodeIdx();
+        uint32_t n1_e = csr.findEdge(n1Idx, n2Idx);
+        bool alreadyConnected = n1_e != CSR_NO_EDGE;
 
         // determine how to link n1 and n2 by link state
         bool n1ConnectionStat = true;
@@ -636,29 +763,19 @@ public:
         // connect the two nodes together if not already connected
         if (!alreadyConnected)
         {
-            ll link_ident = getNewLinkIdent();
+            node_conns.addEdge(n1Idx, n2Idx);
 
-            n1->addLinktoNode(n2, link_weight, link_ident, n1ConnectionStat);
-            n2->addLinktoNode(n1, link_weight, link_ident, n2ConnectionStat);
+            csr.addEdge(n1Idx, n2Idx, link_weight, n1ConnectionStat);
+            csr.addEdge(n2Idx, n1Idx, link_weight, n2ConnectionStat);
             GUIlinks.addLink(n1->getNodePos(), n2->getNodePos(), n1Ident, n2Ident, link_weight, lstate);
             std::cout << "added node link\n";
         }
         else
         {
-            // determine connection from n1 to n2
-            size_t n2_l_idx;
-            bool n2_con;
-            std::vector<ADJ_NODE> links2 = n2->getNodeLinks();
-            for (size_t i = 0; i < links2.size(); ++i)
-            {
-                Node *check = std::get<0>(links2[i]);
-                if (check->getNodeIdent() == n1->getNodeIdent())
-                {
-                    n2_l_idx = i;
-                    n2_con = std::get<3>(links2[i]);
-                    break;
-                }
-            }
+            // determine connection each way, n1's slot knows whether n2 can travel back
+            bool n1_con = csr.canTravel(n1_e);
+            bool n2_con = csr.canTravelBack(n1_e);
+            ll currLinkWeight = csr.weights[n1_e];
 
             std::cout << "\n\tlinkage - already connected:" << n1_con << " " << n2_con << " \n";
             std::cout << "\tconnecting to: " << n1ConnectionStat << " " << n2ConnectionStat << " \n";
@@ -667,8 +784,8 @@ public:
             if (n1ConnectionStat != n1_con || n2ConnectionStat != n2_con)
             {
                 std::cout << "\tUPDATED LINK\n";
-                n1->changeLinkType(n1_l_idx, n1ConnectionStat);
-                n2->changeLinkType(n2_l_idx, n2ConnectionStat);
+                csr.setTravel(n1Idx, n2Idx, n1ConnectionStat);
+                csr.setTravel(n2Idx, n1Idx, n2ConnectionStat);
 
                 GUIlinks.removeLink(n1Ident, n2Ident);
                 GUIlinks.addLink(n1->getNodePos(), n2->getNodePos(), n1Ident, n2Ident, link_weight, lstate);
@@ -676,11 +793,13 @@ public:
             else if (currLinkWeight != link_weight)
             {
                 std::cout << "\tUPDATING LINK WEIGHT\n";
-                n1->changeLinkWeight(n1_l_idx, link_weight);
-                n2->changeLinkWeight(n2_l_idx, link_weight);
+                csr.setWeight(n1_e, link_weight);
+                csr.setWeight(csr.findEdge(n2Idx, n1Idx), link_weight);
                 GUIlinks.updateLinkWeight(n1->getNodeIdent(), n2->getNodeIdent(), link_weight);
             }
         }
+
+        version++;
     }
 
     // removes the link between two nodes and manages graph movement for those nodes
@@ -693,28 +812,26 @@ public:
     void unJoinNodes(Node *n1, Node *n2)
     {
         // Don't attempt to unjoin nodes if they aren't in the same graph
-        size_t graphLoc = node_locs[n2->getNodeIdent()];
+        size_t graphLoc = node_locs.getLoc(n2->getNodeIdx());
         std::cout << "head of graph is " << all_graphs[graphLoc]->getNodeIdent() << std::endl;
         std::cout << "N1: " << n1->getNodeIdent() << " N2: " << n2->getNodeIdent() << std::endl;
-        if (graphLoc != node_locs[n1->getNodeIdent()])
+        if (graphLoc != node_locs.getLoc(n1->getNodeIdx()))
             return;
 
         // erase instance of each node in each others links
-        n1->remLinktoNode(n2->getNodeIdent());
-        n2->remLinktoNode(n1->getNodeIdent());
+        csr.removeEdge(n1->getNodeIdx(), n2->getNodeIdx());
+        csr.removeEdge(n2->getNodeIdx(), n1->getNodeIdx());
+        version++;
 
         // determine if a node needs to be moved to a new graph
-        std::unordered_set<ll> visited;
-        Node *inGraph = graphDFS(n1, n2->getNodeIdent(), visited);
-        visited.clear();
+        bool split = node_conns.removeEdge(n1->getNodeIdx(), n2->getNodeIdx());
 
-        // Check whether n2 or n1 should be moved
+        // Check whether n2 or n1 should be moved, the side without the graph's head moves
         Node *graphHead = all_graphs[graphLoc];
-        bool moveN1 = graphDFS(graphHead, n2->getNodeIdent(), visited) == n2 ? true : false;
-        visited.clear();
+        bool moveN1 = node_conns.connected(graphHead->getNodeIdx(), n2->getNodeIdx());
 
         // Establish n1 or n2 as its own graph if n1 and n2 are separate graphs after link removal
-        if (inGraph == NULL)
+        if (split)
         {
             // determine position of graph n1 or n2 will go to
             size_t new_loc = all_graphs.size();
@@ -734,7 +851,7 @@ public:
                 std::cout << "MOVING N1\n";
                 std::cout << "MOVING NODE " << n1->getNodeIdent() << " TO GRAPH " << new_loc << std::endl;
                 all_graphs[new_loc] = n1;
-                moveGraphLoc(n1, visited, new_loc);
+                moveSplitGraph(n1, n2, new_loc);
             }
             else
             {
@@ -742,7 +859,7 @@ public:
                                                             "is NOT head of graph\n";
                 std::cout << "MOVING NODE " << n2->getNodeIdent() << " TO GRAPH " << new_loc << std::endl;
                 all_graphs[new_loc] = n2;
-                moveGraphLoc(n2, visited, new_loc);
+                moveSplitGraph(n2, n1, new_loc);
             }
 
             num_graphs++;
@@ -758,23 +875,24 @@ public:
 
     */
 
-    // runs DFS move the graph so all nodes within that graph are found at new_loc
-    void moveGraphLoc(Node *curr, std::unordered_set<ll> &visited, size_t new_loc)
+    // moves the graph holding moved to new_loc after it split from the graph holding stayed
+    // only the smaller of the two graphs is relabeled so every node is relabeled O(log n) times
+    void moveSplitGraph(Node *moved, Node *stayed, size_t new_loc)
     {
-        // change where to find node via node_locs
-        ll curr_ident = curr->getNodeIdent();
-        visited.emplace(curr_ident);
-        node_locs[curr_ident] = new_loc;
-        std::cout << "\tnode: " << curr_ident << " moved to: " << new_loc << '\n';
-
-        // DFS to change all attached children to the new location in all_graphs
-        std::vector<ADJ_NODE> links = curr->getNodeLinks();
-        for (size_t i = 0; i < links.size(); ++i)
+        uint32_t movedIdx = moved->getNodeIdx(), stayedIdx = stayed->getNodeIdx();
+        std::vector<uint32_t> idxs;
+        if (node_conns.componentSize(movedIdx) <= node_conns.componentSize(stayedIdx))
+        {
+            node_conns.collectComponent(movedIdx, idxs);
+            node_locs.moveNodes(idxs, new_loc);
+        }
+        else
         {
-            Node *inspect = std::get<0>(links[i]);
-            if (!visited.count(inspect->getNodeIdent()))
-                moveGraphLoc(inspect, visited, new_loc);
+            node_conns.collectComponent(stayedIdx, idxs);
+            node_locs.moveNodes(idxs, node_locs.getLoc(stayedIdx));
+            node_locs.setLoc(movedIdx, new_loc);
         }
+        std::cout << "\t" << node_conns.componentSize(movedIdx) << " nodes moved to: " << new_loc << '\n';
     }
 
     // deletes a given node and updates connected node's positions
@@ -784,17 +902,23 @@ public:
         sf::Vector2i npos = sf::Vector2i(NTD->getNodePos());
         ll NTDident = NTD->getNodeIdent();
 
-        std::vector<ADJ_NODE> links = NTD->getNodeLinks();
-        std::unordered_set<ll> visited;
-        visited.emplace(NTDident);
+        uint32_t NTDidx = NTD->getNodeIdx();
+        size_t NTDloc = node_locs.getLoc(NTDidx);
+
+        // cut NTD's links first so the graph's remaining pieces are known
+        std::vector<uint32_t> links(csr.targets.begin() + csr.edgesBegin(NTDidx), csr.targets.begin() + csr.edgesEnd(NTDidx));
+        for (size_t i = 0; i < links.size(); ++i)
+            node_conns.removeEdge(NTDidx, links[i]);
 
-        // move each child node to a new graph positon & remove link from child to NTD
+        // move each piece to a new graph positon headed by its first child & remove link from child to NTD
+        std::unordered_set<uintptr_t> movedPieces;
+        std::vector<std::pair<Node *, size_t>> pieces; // <piece's head, new all_graphs index>
         for (size_t i = 0; i < links.size(); ++i)
         {
-            Node *child = std::get<0>(links[i]);
+            Node *child = csr.nodes[links[i]];
             ll child_ident = child->getNodeIdent();
 
-            if (!visited.count(child_ident))
+            if (movedPieces.insert(node_conns.componentKey(child->getNodeIdx())).second)
             {
                 size_t new_loc = all_graphs.size();
 
@@ -812,28 +936,52 @@ public:
                     std::cout << "\tmoving to all_graph end\n";
                 }
 
-                // change the graph so all nodes are found at the new_loc
-                moveGraphLoc(child, visited, new_loc);
+                pieces.push_back(std::pair<Node *, size_t>(child, new_loc));
                 num_graphs++;
             }
 
             // remove link from NTD to children node and GUI links
-            child->remLinktoNode(NTDident);
+            csr.removeEdge(links[i], NTDidx);
             GUIlinks.removeLink(NTDident, child_ident);
             // GUIlinks.removeLinkMap(NTDident, child_ident);
         }
 
+        // the largest piece keeps NTD's union-find set, the other pieces are relabeled
+        size_t largest = 0;
+        for (size_t i = 1; i < pieces.size(); ++i)
+        {
+            if (node_conns.componentSize(pieces[i].first->getNodeIdx()) > node_conns.componentSize(pieces[largest].first->getNodeIdx()))
+                largest = i;
+        }
+        for (size_t i = 0; i < pieces.size(); ++i)
+        {
+            if (i == largest)
+                continue;
+            std::vector<uint32_t> idxs;
+            node_conns.collectComponent(pieces[i].first->getNodeIdx(), idxs);
+            node_locs.moveNodes(idxs, pieces[i].second);
+        }
+        if (pieces.size() > 0)
+            node_locs.setLoc(pieces[largest].first->getNodeIdx(), pieces[largest].second);
+
         // remove NTD from graph structure
-        size_t NTDloc = node_locs[NTDident];
         all_graphs[NTDloc] = NULL;
         open_locs.push_back(NTDloc);
-        node_locs.erase(NTDident);
+        node_locs.removeNode(NTDidx);
+        node_conns.removeVertex(NTDidx);
         num_graphs--;
 
         // remove NTD from GUI
-        size_t ipos = simul_width * npos.y + npos.x;
+        uint64_t ipos = worldKey(npos);
         // UPDATING
         node_wlocs.erase(ipos);
+        node_grid.remove(NTD, npos);
+
+        // free NTD's dense index
+        node_slots.erase(NTDidx);
+        node_visuals.remove(NTDidx);
+        csr.removeNode(NTDidx);
+        version++;
 
         // free NTD
         delete NTD;
@@ -860,112 +1008,32 @@ public:
             exit(EXIT_FAILURE);
         }
 
-        bool n1connected = 0, n2connected = 0;
-        size_t idx1, idx2;
         // check that the two nodes are connected to each other and in the same graph
-        std::vector<ADJ_NODE> &l1 = n1->getNodeLinks();
-        std::vector<ADJ_NODE> &l2 = n2->getNodeLinks();
-        for (size_t i = 0; i < l1.size(); ++i)
-        {
-            Node *check = std::get<0>(l1[i]);
-            // search first node for link to second node
-            if (check == n2)
-            {
-                idx2 = i;
-                n1connected = 1;
-                break;
-            }
-        }
-        for (size_t i = 0; i < l2.size(); ++i)
-        {
-            Node *check = std::get<0>(l2[i]);
-            // search second node for link to first node
-            if (check == n1)
-            {
-                idx1 = i;
-                n2connected = 1;
-                break;
-            }
-        }
+        uint32_t e1 = csr.findEdge(n1->getNodeIdx(), n2->getNodeIdx());
+        uint32_t e2 = csr.findEdge(n2->getNodeIdx(), n1->getNodeIdx());
 
         // If the nodes aren't doubly linked to each other exit
-        if (!n1connected || !n2connected)
+        if (e1 == CSR_NO_EDGE || e2 == CSR_NO_EDGE)
         {
-            if (!n1connected)
+            if (e1 == CSR_NO_EDGE)
                 std::cout << "UpdateNodeLink: Error - N1 isn't connected to N2\n";
-            if (!n2connected)
+            if (e2 == CSR_NO_EDGE)
                 std::cout << "UpdateNodeLink: Error - N2 isn't connected to N1\n";
             exit(EXIT_FAILURE);
         }
 
-        n1->changeLinkWeight(idx2, lw);
-        n2->changeLinkWeight(idx1, lw);
+        csr.setWeight(e1, lw);
+        csr.setWeight(e2, lw);
+        if ((ll)lw > max_link_weight)
+            max_link_weight = lw;
+        updateMinWeightPerPixel(n1, n2, lw);
+        version++;
     }
 
     // updates the link connection weight between two nodes by identifier to a given link weight
     void updateNodeLink(ll ident1, ll ident2, size_t lw)
     {
-        std::cout << "UpdateNodeLin:\n\tSearching n1\n";
-        Node *n1 = findNode(ident1);
-        std::cout << "\tSearching n2\n";
-        Node *n2 = findNode(ident2);
-        if (n1 == NULL)
-        {
-            std::cout << "UpdateNodeLink: Error - n1 null\n";
-            exit(EXIT_FAILURE);
-        }
-        if (n2 == NULL)
-        {
-            std::cout << "UpdateNodeLink: Error - n2 null\n";
-            exit(EXIT_FAILURE);
-        }
-        std::cout << "\t\tUpdate Found all nodes\n";
-
-        bool n1connected = 0, n2connected = 0;
-        size_t idx1, idx2;
-        // check that the two nodes are connected to each other and in the same graph
-        std::vector<ADJ_NODE> &l1 = n1->getNodeLinks();
-        std::vector<ADJ_NODE> &l2 = n2->getNodeLinks();
-        for (size_t i = 0; i < l1.size(); ++i)
-        {
-            Node *check = std::get<0>(l1[i]);
-            // search first node for link to second node
-            if (check == n2)
-            {
-                idx2 = i;
-                n1connected = 1;
-                break;
-            }
-        }
-        for (size_t i = 0; i < l2.size(); ++i)
-        {
-            Node *check = std::get<0>(l2[i]);
-            // search second node for link to first node
-            if (check == n1)
-            {
-                idx1 = i;
-                n2connected = 1;
-                break;
-            }
-        }
-
-        // If the nodes aren't doubly linked to each other exit
-        if (!n1connected || !n2connected)
-        {
-            if (!n1connected)
-                std::cout << "UpdateNodeLink: Error - N1 isn't connected to N2\n";
-            if (!n2connected)
-                std::cout << "UpdateNodeLink: Error - N2 isn't connected to N1\n";
-            exit(EXIT_FAILURE);
-        }
-
-        // update link weight for n1
-        ADJ_NODE &change = l1[idx2];
-        std::get<1>(change) = lw;
-
-        // update link weight for n2
-        ADJ_NODE &change2 = l2[idx1];
-        std::get<1>(change2) = lw;
+        updateNodeLink(findNode(ident1), findNode(ident2), lw);
     }
 
     // debug function to see the link weight between two nodes
@@ -973,30 +1041,21 @@ public:
     {
         Node *n1 = findNode(ident1);
         Node *n2 = findNode(ident2);
-
-        std::vector<ADJ_NODE> l1 = n1->getNodeLinks();
-        std::vector<ADJ_NODE> l2 = n2->getNodeLinks();
-        for (size_t i = 0; i < l1.size(); ++i)
+        if (n1 == NULL || n2 == NULL)
         {
-            Node *check = std::get<0>(l1[i]);
-            // search first node for link to second node
-            if (check == n2)
-            {
-                std::cout << "displayLinkWeight:\n\t" << ident1 << " -> " << ident2 << " weight: " << std::get<1>(l1[i]);
-                break;
-            }
+            std::cout << "displayLinkWeight: " << (n1 ? ident2 : ident1) << " doesn't exist\n";
+            return;
         }
 
-        for (size_t i = 0; i < l2.size(); ++i)
-        {
-            Node *check = std::get<0>(l2[i]);
-            // search second node for link to first node
-            if (check == n1)
-            {
-                std::cout << "\n\t" << ident2 << " -> " << ident1 << " weight: " << std::get<1>(l2[i]) << std::endl;
-                break;
-            }
-        }
+        uint32_t e1 = csr.findEdge(n1->getNodeIdx(), n2->getNodeIdx());
+        uint32_t e2 = csr.findEdge(n2->getNodeIdx(), n1->getNodeIdx());
+        // search first node for link to second node
+        if (e1 != CSR_NO_EDGE)
+            std::cout << "displayLinkWeight:\n\t" << ident1 << " -> " << ident2 << " weight: " << csr.weights[e1];
+
+        // search second node for link to first node
+        if (e2 != CSR_NO_EDGE)
+            std::cout << "\n\t" << ident2 << " -> " << ident1 << " weight: " << csr.weights[e2] << std::endl;
     }
 
     /*
@@ -1006,45 +1065,20 @@ public:
 
     */
 
-    // helper function for eraseGraph that uses visited set in order to recursively delete all nodes in a graph
-    void eraseGraphHelper(Node *curr, std::unordered_set<Node *> &visited)
-    {
-        std::cout << "\tNode " << curr->getNodeIdent() << " has been visited\n";
-        // mark current node as visited
-        visited.insert(curr);
-
-        // inspect the links of the current node if they are not visited
-        std::vector<ADJ_NODE> links = curr->getNodeLinks();
-        for (size_t i = 0; i < links.size(); ++i)
-        {
-            Node *inspect = std::get<0>(links[i]);
-
-            if (!visited.count(inspect))
-            {
-                std::cout << "\t\tinspecting Node: " << inspect->getNodeIdent() << "\n";
-                eraseGraphHelper(inspect, visited);
-            }
-        }
-
-        // after all current links have been visited delete memory of current node
-        std::cout << "\tdeleting Node: " << curr->getNodeIdent() << std::endl;
-        delete curr;
-        curr = NULL;
-        if (curr)
-        {
-            std::cout << "\tNode exists?? - " << curr->getNodeIdent() << std::endl;
-        }
-    }
-
     // erases all nodes in a graph given the head node of that graph
+    // nodes are collected first, links of a deleted node can't be followed anymore
     void eraseGraph(Node *graph_head)
     {
         std::cout << "\n\nErasing Graph\n";
-        // set to mark nodes as visited
-        std::unordered_set<Node *> visited;
+        std::vector<Node *> erased;
+        CollectVisitor collect(erased);
+        traversal.depthFirst(csr, graph_head, collect);
 
-        // erase entire graph
-        eraseGraphHelper(graph_head, visited);
+        for (Node *n : erased)
+        {
+            std::cout << "\tdeleting Node: " << n->getNodeIdent() << std::endl;
+            delete n;
+        }
     }
 
     // erases every node in all of the graphs
@@ -0,0 +1,92 @@
+/*
+graphTraversal.hpp
+    - Iterative depth first traversal of the linked nodes in the link store, used by the graph for drawing, listing and erasing
+    - An explicit stack replaces recursion so long path shaped graphs can't overflow the call stack
+    - Visited nodes are stamped with the traversal's epoch by dense index, so starting a traversal clears nothing and allocates nothing once warmed up
+ */
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include "csr.hpp"
+
+// Called for every node a traversal reaches, in the order recursing through the links would reach them
+class INodeVisitor
+{
+public:
+    // Returns false to stop the traversal at n
+    virtual bool visit(Node *n) = 0;
+
+    virtual ~INodeVisitor() {}
+};
+
+class GraphTraversal
+{
+private:
+    // Dense index of a node on the path from the root and the edge slot of the next of its links to follow
+    struct Frame
+    {
+        uint32_t idx;
+        uint32_t nextEdge;
+    };
+
+    std::vector<Frame> stack;     // Kept between traversals so its capacity is reused
+    std::vector<uint32_t> stamps; // <dense index, epoch the node was last visited in>
+    uint32_t epoch;               // Stamp of the current traversal
+
+    // Stamps the node at idx as visited, returns false if it already was
+    bool markVisited(uint32_t idx)
+    {
+        if (idx >= stamps.size())
+            stamps.resize(idx + 1, 0);
+        if (stamps[idx] == epoch)
+            return false;
+        stamps[idx] = epoch;
+        return true;
+    }
+
+    // Starts a new epoch, stamps are only cleared when the epoch wraps around
+    void nextEpoch()
+    {
+        if (++epoch == 0)
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+public:
+    GraphTraversal() : epoch(0) {}
+
+    // Visits root and every node linked to it in csr depth first, following links both ways
+    // Returns the node the visitor stopped at, NULL if every node was visited
+    // Visitors can't start another traversal on the same engine or change the links
+    Node *depthFirst(const GraphCSR &csr, Node *root, INodeVisitor &visitor)
+    {
+        nextEpoch();
+        stack.clear();
+        uint32_t rootIdx = root->getNodeIdx();
+        markVisited(rootIdx);
+        if (!visitor.visit(root))
+            return root;
+        stack.push_back(Frame{rootIdx, csr.edgesBegin(rootIdx)});
+
+        while (!stack.empty())
+        {
+            Frame &top = stack.back();
+            if (top.nextEdge == csr.edgesEnd(top.idx))
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            uint32_t linked = csr.targets[top.nextEdge++];
+            if (!markVisited(linked))
+                continue;
+            if (!visitor.visit(csr.nodes[linked]))
+                return csr.nodes[linked];
+            stack.push_back(Frame{linked, csr.edgesBegin(linked)});
+        }
+        return NULL;
+    }
+};
@@ -10,6 +10,17 @@ gui.hpp
 #define REM_SHADOW_COLOR sf::Color::Red
 #define SIMUL_STATE_DISPLAY_COLOR sf::Color(255, 156, 18)
 #define CONTROL_BORDER_COLOR sf::Color(105, 105, 150)
+#define GUI_IDLE_SLEEP_MS 10  // Wait between checks for something new to draw while idle
+#define GUI_SETTLE_MS 250     // Frames keep being drawn this long after the last change so ImGui can finish reacting to it
+#define GUI_IDLE_FRAME_MS 100 // Longest time between frames while idle, ImGui keeps updating its hover states and tooltips at this rate
+#define CAMERA_ZOOM_STEP 1.15f  // Scale change of one mouse wheel notch
+#define CAMERA_MIN_SCALE 0.125f // World units per pixel when zoomed in the most
+
+// Levels of detail by how many pixels a node's radius takes on screen
+#define LOD_DETAIL_MIN_RADIUS_PX 6.f    // Below this node labels, link weights and arrowheads are skipped
+#define LOD_CIRCLE_MIN_RADIUS_PX 1.5f   // Below this nodes are drawn as points
+#define LOD_RASTER_MIN_RADIUS_PX 0.25f  // Below this the graph is drawn as its density raster
+#define LOD_POINT_NODE_BUDGET 50000     // Graphs with more nodes skip the points level for the raster, so zoomed out frames stay bounded
 
 // Created seperate enums for removing nodes and links (don't know if this will be the case in the future)
 enum class SimulState
@@ -42,6 +53,20 @@ private:
     std::vector<sf::Vertex> tempInputLink;
     std::vector<sf::Vertex> tempInputArrows;
 
+    // Part of the world shown in the simul area, panned with the middle mouse button and zoomed with the wheel
+    sf::View camera;
+    size_t cameraRevision; // Bumped whenever the camera moves or zooms
+
+    // Links and nodes in view are drawn into graphLayer only when the graph's scene revision or the camera changes, every frame just draws the layer
+    sf::RenderTexture graphLayer;
+    sf::Sprite graphLayerSprite;
+    size_t layerRevision;       // Scene revision graphLayer was last drawn at
+    size_t layerCameraRevision; // Camera revision graphLayer was last drawn at
+    bool layerDrawn;      // Whether graphLayer has been drawn at all
+    bool sceneDirty;      // Set by changes outside the graph layer: input, ImGui and shadow links
+    sf::Clock sinceDirty; // Time since frameNeeded last took sceneDirty
+    sf::Clock sinceFrame; // Time since frameNeeded last asked for a frame
+
     // sf::Vertex* shadowLink[2];
 
     // NOTE: currently just supporting positive weights
@@ -74,6 +99,7 @@ public:
         simul_width = s_width;
         simul_height = s_height;
         graphMan = new Graph(win_width, win_height, simul_width, simul_height);
+        algoMan.setGraph(graphMan);
 
         if (!simulStateFont.loadFromFile("./Dijkstras/fonts/Mollen/Mollen-Bold.otf"))
         {
@@ -97,6 +123,128 @@ public:
         controlBorder.setSize(sf::Vector2f(w_width - s_width, s_height));
         controlBorder.setFillColor(CONTROL_BORDER_COLOR);
         controlBorder.setPosition(s_width, 0);
+
+        camera.reset(sf::FloatRect(0, 0, simul_width, simul_height));
+        cameraRevision = 0;
+
+        graphLayer.create(simul_width, simul_height);
+        graphLayerSprite.setTexture(graphLayer.getTexture());
+        layerRevision = 0;
+        layerCameraRevision = 0;
+        layerDrawn = false;
+        sceneDirty = true;
+    }
+
+    // Something not in the graph layer changed, the next frame has to be drawn
+    inline void markSceneDirty()
+    {
+        sceneDirty = true;
+    }
+
+    // Whether the window has to be drawn again, false while nothing on it can have changed since the last frame
+    // Idle frames still come every GUI_IDLE_FRAME_MS for ImGui, they reuse the graph layer since it isn't stale
+    bool frameNeeded()
+    {
+        bool needed = true;
+        if (sceneDirty)
+        {
+            sceneDirty = false;
+            sinceDirty.restart();
+        }
+        else
+        {
+            bool playing = algoMan.algoRunning && algoMan.playMode == AlgoAnimationMode::Play;
+            bool layerStale = !layerDrawn || graphMan->getSceneRevision() != layerRevision || cameraRevision != layerCameraRevision;
+            needed = playing || layerStale || ImGui::GetIO().WantTextInput ||
+                     sinceDirty.getElapsedTime().asMilliseconds() < GUI_SETTLE_MS ||
+                     sinceFrame.getElapsedTime().asMilliseconds() >= GUI_IDLE_FRAME_MS;
+        }
+        if (needed)
+            sinceFrame.restart();
+        return needed;
+    }
+
+    /*
+        Camera
+            - maps between window pixels in the simul area and world positions
+            - pans and zooms the part of the world shown
+    */
+
+    // Whether a window pixel lies in the simul area
+    inline bool pixelInSimul(const sf::Vector2i &pixel) const
+    {
+        return pixel.x >= 0 && pixel.y >= 0 && pixel.x < (int)simul_width && pixel.y < (int)simul_height;
+    }
+
+    // World position under a window pixel, the graph layer covers the simul area from the window's corner
+    inline sf::Vector2f toWorld(const sf::Vector2i &pixel) const
+    {
+        return graphLayer.mapPixelToCoords(pixel, camera);
+    }
+
+    // World position under the mouse, rounded to the integer positions nodes are placed at
+    inline sf::Vector2i mouseWorldPos(const sf::RenderWindow *win) const
+    {
+        sf::Vector2f world = toWorld(sf::Mouse::getPosition(*win));
+        return sf::Vector2i(std::floor(world.x), std::floor(world.y));
+    }
+
+    // World units per pixel of the simul area
+    inline float cameraScale() const
+    {
+        return camera.getSize().x / simul_width;
+    }
+
+    // World rect the camera shows
+    inline sf::FloatRect cameraRect() const
+    {
+        sf::Vector2f size = camera.getSize();
+        return sf::FloatRect(camera.getCenter() - size / 2.f, size);
+    }
+
+    // Camera drawn into the simul area of the window instead of a layer of its size
+    sf::View simulView(const sf::RenderWindow *win) const
+    {
+        sf::View view = camera;
+        sf::Vector2u size = win->getSize();
+        view.setViewport(sf::FloatRect(0, 0, (float)simul_width / size.x, (float)simul_height / size.y));
+        return view;
+    }
+
+    // Moves the camera so the world follows the mouse by a pixel offset
+    void panCamera(const sf::Vector2i &pixelOffset)
+    {
+        if (pixelOffset == sf::Vector2i(0, 0))
+            return;
+        camera.move(toWorld(sf::Vector2i(0, 0)) - toWorld(pixelOffset));
+        clampCamera();
+        cameraRevision++;
+    }
+
+    // Zooms in for positive wheel notches and out for negative ones, keeping the world position under the pixel in place
+    void zoomCamera(float notches, const sf::Vector2i &pixel)
+    {
+        float scale = cameraScale();
+        float newScale = scale * std::pow(CAMERA_ZOOM_STEP, -notches);
+        float maxScale = (float)GRAPH_WORLD_SIZE / simul_width;
+        newScale = newScale < CAMERA_MIN_SCALE ? CAMERA_MIN_SCALE : (newScale > maxScale ? maxScale : newScale);
+        if (newScale == scale)
+            return;
+
+        sf::Vector2f anchor = toWorld(pixel);
+        camera.zoom(newScale / scale);
+        camera.move(anchor - toWorld(pixel));
+        clampCamera();
+        cameraRevision++;
+    }
+
+    // Keeps the camera's center inside the world
+    void clampCamera()
+    {
+        sf::Vector2f center = camera.getCenter();
+        center.x = center.x < 0 ? 0 : (center.x > GRAPH_WORLD_SIZE ? GRAPH_WORLD_SIZE : center.x);
+        center.y = center.y < 0 ? 0 : (center.y > GRAPH_WORLD_SIZE ? GRAPH_WORLD_SIZE : center.y);
+        camera.setCenter(center);
     }
 
     // returns the euclidean distance between two integer points
@@ -118,10 +266,10 @@ public:
                 node_xs = 0;
             if (node_ys < 0)
                 node_ys = 0;
-            if (node_xe >= simul_width)
-                node_xe = simul_width - 1;
-            if (node_ye >= simul_height)
-                node_ye = simul_height - 1;
+            if (node_xe >= GRAPH_WORLD_SIZE)
+                node_xe = GRAPH_WORLD_SIZE - 1;
+            if (node_ye >= GRAPH_WORLD_SIZE)
+                node_ye = GRAPH_WORLD_SIZE - 1;
 
             if (euclidDist(npos, mpos) <= node_radius &&
                 ((node_xs <= mpos.x) && (mpos.x <= node_xe)) &&
@@ -138,47 +286,52 @@ public:
     Node *mouseOverNode(const sf::RenderWindow *win, size_t node_radius)
     {
         // Node** iloc = graphMan->getNodeIlocs();
-        sf::Vector2i mpos = sf::Mouse::getPosition(*win);
+        sf::Vector2i pixel = sf::Mouse::getPosition(*win);
 
         // determine if mouse is over valid range
         //  UPDATING
-        if (mpos.x >= 0 && mpos.y >= 0 && mpos.x <= simul_width && mpos.y <= simul_height)
+        if (pixel.x >= 0 && pixel.y >= 0 && pixel.x <= simul_width && pixel.y <= simul_height)
         {
-            // determine where to start looking for the node
+            // determine where to start looking for the node, in world positions
+            sf::Vector2i mpos = mouseWorldPos(win);
             int ys = mpos.y - node_radius, ye = mpos.y + node_radius;
             int xs = mpos.x - node_radius, xe = mpos.x + node_radius;
             if (ys < 0)
                 ys = 0;
             if (xs < 0)
                 xs = 0;
-            if (xe >= simul_width)
-                xe = simul_width - 1;
-            if (ye >= simul_height)
-                ye = simul_height - 1;
-
-
-            // search the interface reduced range
-            for (int y = ys; y <= ye; ++y)
+            if (xe >= GRAPH_WORLD_SIZE)
+                xe = GRAPH_WORLD_SIZE - 1;
+            if (ye >= GRAPH_WORLD_SIZE)
+                ye = GRAPH_WORLD_SIZE - 1;
+
+
+            // search the nodes bucketed around the mouse, the topmost then leftmost node under the mouse wins
+            std::vector<Node *> near;
+            graphMan->getNodesNear(mpos, node_radius, near);
+            Node *found = NULL;
+            sf::Vector2i foundPos;
+            for (Node *cpn : near)
             {
-                for (int x = xs; x <= xe; ++x)
+                sf::Vector2i cpos = sf::Vector2i(cpn->getNodePos());
+                if (cpos.x < xs || cpos.x > xe || cpos.y < ys || cpos.y > ye || !withinBoundary(cpn, mpos, node_radius))
+                    continue;
+                if (!found || cpos.y < foundPos.y || (cpos.y == foundPos.y && cpos.x < foundPos.x))
                 {
-                    size_t idx = simul_width * y + x;
-                    Node *cpn = graphMan->getNodeAtPosition(idx);
-                    if (cpn != NULL && withinBoundary(cpn, mpos, node_radius))
-                    {
-                        return cpn;
-                    }
+                    found = cpn;
+                    foundPos = cpos;
                 }
             }
+            return found;
         }
 
         return NULL;
     }
 
+    // whether the mouse is over the simul area at a world position a node fits at
     bool nodeWithinSimulBoundary(const sf::RenderWindow *win)
     {
-        sf::Vector2i mpos = sf::Mouse::getPosition(*win);
-        if (mpos.x - NODE_RADIUS >= 0 && mpos.y - NODE_RADIUS >= 0 && mpos.x + NODE_RADIUS <= simul_width && mpos.y + NODE_RADIUS <= simul_height)
+        if (pixelInSimul(sf::Mouse::getPosition(*win)) && Graph::inWorld(mouseWorldPos(win)))
         {
             return true;
         }
@@ -211,17 +364,18 @@ public:
         }
     }
 
-    // updates the node position the left mouse button is pressing on to a dragged postion
+    // updates the node position the left mouse button is pressing on to a dragged postion, prev_mpos is a world position
+    // a blocked move keeps prev_mpos, so the node catches up with the mouse once the way is clear
     void onDragNode(const sf::RenderWindow *win, Node *mouse_on_node, sf::Vector2i &prev_mpos, bool &dragging)
     {
         if (mouse_on_node && dragging)
         {
-            sf::Vector2i curr_mpos = sf::Mouse::getPosition(*win);
+            sf::Vector2i curr_mpos = mouseWorldPos(win);
             if (curr_mpos != prev_mpos)
             {
                 sf::Vector2i move_offset = curr_mpos - prev_mpos;
-                std::cout << "\tOFFSET x: " << move_offset.x << " y: " << move_offset.y << '\n';
-                prev_mpos = curr_mpos;
+                if (graphMan->moveNode(mouse_on_node, sf::Vector2i(mouse_on_node->getNodePos()) + move_offset))
+                    prev_mpos = curr_mpos;
             }
         }
     }
@@ -232,8 +386,8 @@ public:
         // adds node if new node doesn't overlap with existing nodes
         if (nodeWithinSimulBoundary(win) && !mouseOverNode(win, NODE_RADIUS * 4))
         {
-            sf::Vector2i pos = sf::Mouse::getPosition(*win);
-            std::cout << "2 - node created at position: " << simul_width * pos.y + pos.x << " x: " << pos.x << " y: " << pos.y << '\n';
+            sf::Vector2i pos = mouseWorldPos(win);
+            std::cout << "2 - node created at position x: " << pos.x << " y: " << pos.y << '\n';
             graphMan->createNewNode(pos, nodeFont);
         }
     }
@@ -308,6 +462,7 @@ public:
 
             shadowLink.push_back(sf::Vertex(n1Pos, lcolor));
             shadowLink.push_back(sf::Vertex(n1Pos, lcolor));
+            sceneDirty = true;
         }
     }
 
@@ -316,7 +471,7 @@ public:
     {
         if (n1)
         {
-            sf::Vector2f n2Pos = sf::Vector2f(sf::Mouse::getPosition(*win));
+            sf::Vector2f n2Pos = sf::Vector2f(mouseWorldPos(win));
 
             sf::Color lcolor;
             if (lstate == LinkStat::Doubly)
@@ -326,6 +481,8 @@ public:
 
             if (shadowLink.size() == 2)
             {
+                if (shadowLink[1].position != n2Pos)
+                    sceneDirty = true;
                 shadowLink[1] = sf::Vertex(n2Pos, lcolor);
             }
             if (shadowArrows.size() == 4)
@@ -344,6 +501,8 @@ public:
     // resets the shadow link
     inline void clearShadowLink(const LinkStat &lstate)
     {
+        if (!shadowLink.empty())
+            sceneDirty = true;
         shadowLink.clear();
         if (lstate == LinkStat::SinglyTo)
             shadowArrows.clear();
@@ -356,6 +515,7 @@ public:
         {
             shadowRemoveLink.push_back(sf::Vertex(n1->getNodePos(), REM_SHADOW_COLOR));
             shadowRemoveLink.push_back(sf::Vertex(n1->getNodePos(), REM_SHADOW_COLOR));
+            sceneDirty = true;
         }
     }
 
@@ -364,9 +524,11 @@ public:
     {
         if (n1)
         {
-            sf::Vector2f pos = sf::Vector2f(sf::Mouse::getPosition(*win));
+            sf::Vector2f pos = sf::Vector2f(mouseWorldPos(win));
             if (shadowRemoveLink.size() == 2)
             {
+                if (shadowRemoveLink[1].position != pos)
+                    sceneDirty = true;
                 shadowRemoveLink[1] = sf::Vertex(pos, REM_SHADOW_COLOR);
             }
         }
@@ -393,11 +555,14 @@ public:
 
         tempInputLink.push_back(sf::Vertex(n1Pos, lcolor));
         tempInputLink.push_back(sf::Vertex(n2Pos, lcolor));
+        sceneDirty = true;
     }
 
     // resets the shadow link
     inline void clearTempLink(const LinkStat &lstate)
     {
+        if (!tempInputLink.empty())
+            sceneDirty = true;
         tempInputLink.clear();
         if (lstate == LinkStat::SinglyTo)
             tempInputArrows.clear();
@@ -405,6 +570,8 @@ public:
 
     inline void clearShadowRemoveLink()
     {
+        if (!shadowRemoveLink.empty())
+            sceneDirty = true;
         shadowRemoveLink.clear();
     }
 
@@ -421,8 +588,10 @@ public:
         ImGui::End();
     }
 
+    // draws the shadow and temporary links through the camera
     void renderLinks(sf::RenderWindow *win)
     {
+        win->setView(simulView(win));
         if (shadowLink.size() > 0)
         {
             win->draw(shadowLink.data(), shadowLink.size(), sf::Lines);
@@ -443,17 +612,48 @@ public:
         {
             win->draw(tempInputArrows.data(), tempInputArrows.size(), sf::Lines);
         }
+        win->setView(win->getDefaultView());
     }
 
-    // renders all elements of all the graphs
+    // renders the elements of all the graphs the camera shows, redrawing the graph layer first if the graph or camera changed since it was drawn
+    // Only the nodes and links found in view through the spatial indices are drawn, so the cost follows what is on screen
     void renderGraphs(sf::RenderWindow *win)
     {
-        graphMan->drawAllLinks(win);
-        size_t ags = graphMan->getAllGraphSize();
-        for (size_t i = 0; i < ags; ++i)
+        size_t revision = graphMan->getSceneRevision();
+        if (!layerDrawn || revision != layerRevision || cameraRevision != layerCameraRevision)
         {
-            graphMan->drawAllNodesinGraph(i, win);
+            graphLayer.setView(camera);
+            graphLayer.clear(sf::Color::Transparent);
+            drawGraphLOD(&graphLayer);
+            graphLayer.display();
+            layerRevision = revision;
+            layerCameraRevision = cameraRevision;
+            layerDrawn = true;
         }
+
+        // Drawing over transparent left the layer's colors multiplied by their alpha already
+        win->draw(graphLayerSprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+    }
+
+    // draws the graph in view with as much detail as the camera's zoom leaves room for
+    void drawGraphLOD(sf::RenderTarget *target)
+    {
+        float radiusPx = NODE_RADIUS / cameraScale();
+        bool crowded = radiusPx < LOD_CIRCLE_MIN_RADIUS_PX && graphMan->getNumNodes() > LOD_POINT_NODE_BUDGET;
+        if (radiusPx < LOD_RASTER_MIN_RADIUS_PX || crowded)
+        {
+            graphMan->drawDensity(target);
+            return;
+        }
+
+        bool detailed = radiusPx >= LOD_DETAIL_MIN_RADIUS_PX;
+        NodeDetail detail = NodeDetail::Point;
+        if (detailed)
+            detail = NodeDetail::Labeled;
+        else if (radiusPx >= LOD_CIRCLE_MIN_RADIUS_PX)
+            detail = NodeDetail::Plain;
+        graphMan->drawLinksIn(target, cameraRect(), detailed);
+        graphMan->drawNodesIn(target, cameraRect(), detail);
     }
 
     void renderLinkWeightBox(Node *n1, Node *n2, const LinkStat &lstate, bool &textInputting, bool &checkLinking)
@@ -512,6 +712,9 @@ public:
 
     void drawIMAlgoMenu(AlgoToRun &runAlgo, SimulState &state)
     {
+        algoMan.updateLandmarks();
+        algoMan.updateHierarchy();
+
         // Don't display run algo or algo menu if in view mode (algo is running)
         if (state == SimulState::ViewMode)
             return;
@@ -545,6 +748,17 @@ public:
             size_t w = simul_width + 20, h = win_height / 2, bh = 25, space = 7;
             ImVec2 buttonSize(23, 23);
 
+            // Ran to completion, step panel isn't built until the user opens it
+            if (!algoMan.stepsShown)
+            {
+                drawIMAlgoResult(state, ImVec2(w, h));
+                return;
+            }
+
+            // Play the steps due this frame before anything reads the current step
+            algoMan.algoUpdatePlay(ImGui::GetIO().DeltaTime);
+            bool playing = algoMan.playMode == AlgoAnimationMode::Play;
+
             // Algo panel
             ImGui::Begin(algoMan.runningAlgoName.c_str(), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
             ImGui::SetWindowPos(ImVec2(w, h));
@@ -552,15 +766,53 @@ public:
             // Algo play butons
             ImGui::BeginGroup();
             ImGui::SetCursorPos(ImVec2(space, bh));
-            bool stepForward = ImGui::Button(">", buttonSize);
+            bool stepBackward = ImGui::Button("<", buttonSize);
 
             ImGui::SetCursorPos(ImVec2(space + (buttonSize.x + space), bh));
+            bool togglePlay = ImGui::Button(playing ? "||###AlgoPlay" : "|>###AlgoPlay", buttonSize);
+
+            ImGui::SetCursorPos(ImVec2(space + 2 * (buttonSize.x + space), bh));
+            bool stepForward = ImGui::Button(">", buttonSize);
+
+            ImGui::SetCursorPos(ImVec2(space + 3 * (buttonSize.x + space), bh));
             bool quit = ImGui::Button("X", buttonSize);
 
-            if (stepForward)
+            // Seek to any step that has been ran
+            IAnimImpl *algoAnim = algoMan.algoAnim;
+            int seekStep = algoAnim->getCurrStep();
+            int lastStep = algoAnim->getNumSteps() - 1;
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(200);
+            bool seek = ImGui::SliderInt("###AlgoSeek", &seekStep, 0, lastStep > 0 ? lastStep : 1, algoAnim->getStepString().c_str());
+
+            // Play speed
+            ImGui::SetCursorPosX(space);
+            ImGui::SetNextItemWidth(200);
+            ImGui::SliderFloat("Steps/sec", &algoMan.stepsPerSecond, ALGO_PLAY_MIN_STEPS_PER_SEC, ALGO_PLAY_MAX_STEPS_PER_SEC, "%.0f", ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_AlwaysClamp);
+
+            // Stepping by hand pauses playing
+            if (togglePlay)
+            {
+                if (playing)
+                    algoMan.algoPause();
+                else
+                    algoMan.algoPlay();
+            }
+            else if (stepBackward)
             {
+                algoMan.algoPause();
+                algoMan.algoStepBackward();
+            }
+            else if (stepForward)
+            {
+                algoMan.algoPause();
                 algoMan.algoStepForward();
             }
+            else if (seek && seekStep >= 0 && seekStep <= lastStep)
+            {
+                algoMan.algoPause();
+                algoMan.algoSeekStep(seekStep);
+            }
             else if (quit)
             {
                 state = SimulState::AddNodeMode;
@@ -574,10 +826,9 @@ public:
             // Print messages
             ImVec2 childSize = ImVec2(0, 150); // Width auto, 150px height
             ImGui::BeginChild("ScrollingRegion", childSize, true, ImGuiWindowFlags_HorizontalScrollbar);
-            for (const auto &line : algoMan.algoGetStepDescription())
-            {
-                ImGui::TextUnformatted(line.c_str());
-            }
+            // Single text block, imgui skips the lines outside the region
+            const std::string &stepText = algoMan.algoGetStepText();
+            ImGui::TextUnformatted(stepText.c_str(), stepText.c_str() + stepText.size());
 
             // Scroll to the bottom of the text box
             float scrollY = ImGui::GetScrollY();
@@ -628,6 +879,76 @@ public:
         }
     }
 
+    // Result panel of an algo ran to completion
+    void drawIMAlgoResult(SimulState &state, const ImVec2 &pos)
+    {
+        const AlgoResult &result = algoMan.algoGetResult();
+        std::string algoName = algo_list[(int)algoMan.runAlgo];
+
+        ImGui::Begin(("Result for " + algoName + "###AlgoResult").c_str(), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
+        ImGui::SetWindowPos(pos);
+
+        bool showSteps = ImGui::Button("Show steps");
+        ImGui::SameLine();
+        bool quit = ImGui::Button("X", ImVec2(23, 23));
+
+        ImGui::Text("Visited %zu nodes", result.visitOrder.size());
+        if (algoMan.runAlgo != AlgoToRun::Dijkstra)
+        {
+            // Path from start to the find node
+            if (result.found)
+            {
+                std::string pathText = "Path:";
+                for (Node *n : algoMan.algoGetResultPath())
+                    pathText += " " + std::to_string(n->getNodeIdent());
+                const char *distName = algoMan.runAlgo >= AlgoToRun::BiDijkstra ? "path weight" : "depth";
+                ImGui::Text("Found node %lld at %s %lld", algoMan.findN->getNodeIdent(), distName, result.dist[algoMan.findN->getNodeIdx()]);
+                ImGui::TextWrapped("%s", pathText.c_str());
+            }
+            else
+            {
+                ImGui::Text("Failed to find node %lld", algoMan.findN->getNodeIdent());
+            }
+        }
+        else if (ImGui::BeginTable("Result Weight Table", 3, ImGuiTableFlags_ScrollY, ImVec2(0, 200)))
+        {
+            // Only the visible rows are submitted
+            ImGui::TableSetupColumn("Node");
+            ImGui::TableSetupColumn("Weight");
+            ImGui::TableSetupColumn("Parent");
+            ImGui::TableHeadersRow();
+            ImGuiListClipper clipper;
+            clipper.Begin(result.visitOrder.size());
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                {
+                    Node *n = result.visitOrder[row];
+                    Node *parent = result.parent[n->getNodeIdx()];
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextUnformatted(std::to_string(n->getNodeIdent()).c_str());
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::TextUnformatted(std::to_string(result.dist[n->getNodeIdx()]).c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::TextUnformatted(parent ? std::to_string(parent->getNodeIdent()).c_str() : "-");
+                }
+            }
+            ImGui::EndTable();
+        }
+        ImGui::End();
+
+        if (showSteps)
+        {
+            algoMan.showAlgoSteps();
+        }
+        else if (quit)
+        {
+            state = SimulState::AddNodeMode;
+            algoMan.quitAlgo();
+        }
+    }
+
     void drawControlBorder(sf::RenderWindow *win)
     {
         win->draw(controlBorder);
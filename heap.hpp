@@ -0,0 +1,183 @@
+/*
+heap.hpp
+    - Indexed d-ary min heap with decrease key
+    - Items are dense indices (0..n) so positions are tracked in flat arrays instead of maps
+    - Equal keys pop the lowest item first, so the pop order only depends on the keys pushed
+ */
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+typedef long long ll;
+
+// Indexed d-ary min heap keyed by dense item index
+// An item can only be in the heap once, pushing an item that is already in the heap lowers its key
+template <size_t D = 4>
+class IndexedHeap
+{
+private:
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+    std::vector<uint32_t> heap; // <heap position, item>
+    std::vector<uint32_t> pos;  // <item, heap position> (NOT_IN_HEAP if item isn't in the heap)
+    std::vector<ll> keys;       // <item, key of item>
+
+    // Grows the item arrays so item can be indexed
+    void fitItem(uint32_t item)
+    {
+        if (item >= pos.size())
+        {
+            pos.resize(item + 1, NOT_IN_HEAP);
+            keys.resize(item + 1, 0);
+        }
+    }
+
+    // Whether item a pops before item b, ties go to the lower item
+    inline bool before(uint32_t a, uint32_t b) const
+    {
+        return keys[a] != keys[b] ? keys[a] < keys[b] : a < b;
+    }
+
+    inline void place(size_t hpos, uint32_t item)
+    {
+        heap[hpos] = item;
+        pos[item] = hpos;
+    }
+
+    // Moves item at heap position up until its parent pops before it
+    void siftUp(size_t hpos)
+    {
+        uint32_t item = heap[hpos];
+        while (hpos > 0)
+        {
+            size_t parent = (hpos - 1) / D;
+            if (before(heap[parent], item))
+                break;
+            place(hpos, heap[parent]);
+            hpos = parent;
+        }
+        place(hpos, item);
+    }
+
+    // Moves item at heap position down until it pops before all of its children
+    void siftDown(size_t hpos)
+    {
+        uint32_t item = heap[hpos];
+        while (true)
+        {
+            size_t first = hpos * D + 1;
+            if (first >= heap.size())
+                break;
+
+            // Find the child that pops first
+            size_t last = first + D < heap.size() ? first + D : heap.size();
+            size_t smallest = first;
+            for (size_t c = first + 1; c < last; ++c)
+            {
+                if (before(heap[c], heap[smallest]))
+                    smallest = c;
+            }
+
+            if (before(item, heap[smallest]))
+                break;
+            place(hpos, heap[smallest]);
+            hpos = smallest;
+        }
+        place(hpos, item);
+    }
+
+public:
+    IndexedHeap() {}
+
+    // Reserve space for items 0..n
+    void reserve(size_t n)
+    {
+        heap.reserve(n);
+        pos.reserve(n);
+        keys.reserve(n);
+    }
+
+    inline bool empty() const
+    {
+        return heap.empty();
+    }
+
+    inline size_t size() const
+    {
+        return heap.size();
+    }
+
+    inline bool contains(uint32_t item) const
+    {
+        return item < pos.size() && pos[item] != NOT_IN_HEAP;
+    }
+
+    // Key of an item currently in the heap
+    inline ll getKey(uint32_t item) const
+    {
+        assert(contains(item));
+        return keys[item];
+    }
+
+    // Inserts item, or lowers its key if it is already in the heap
+    // Returns false if item is already in the heap with a key that is smaller or equal
+    bool push(uint32_t item, ll key)
+    {
+        fitItem(item);
+        if (pos[item] == NOT_IN_HEAP)
+        {
+            keys[item] = key;
+            heap.push_back(item);
+            pos[item] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+            return true;
+        }
+        return decreaseKey(item, key);
+    }
+
+    // Lowers key of an item in the heap, returns false if key isn't smaller
+    bool decreaseKey(uint32_t item, ll key)
+    {
+        assert(contains(item));
+        if (key >= keys[item])
+            return false;
+        keys[item] = key;
+        siftUp(pos[item]);
+        return true;
+    }
+
+    // Item with the smallest key
+    inline uint32_t top() const
+    {
+        assert(!empty());
+        return heap[0];
+    }
+
+    // Removes and returns the item with the smallest key, the lowest such item on ties
+    uint32_t pop()
+    {
+        assert(!empty());
+        uint32_t item = heap[0];
+        pos[item] = NOT_IN_HEAP;
+
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            place(0, last);
+            siftDown(0);
+        }
+        return item;
+    }
+
+    // Removes every item, only touches items that are still in the heap
+    void clear()
+    {
+        for (uint32_t item : heap)
+            pos[item] = NOT_IN_HEAP;
+        heap.clear();
+    }
+};
@@ -0,0 +1,66 @@
+/*
+heuristic.hpp
+    - Estimates of the path weight left to a target node, used by A* to search toward the target first
+    - Estimates have to be consistent (never more than a link's weight plus the estimate at the linked node) so settled nodes stay settled
+ */
+#pragma once
+#include <cmath>
+#include "csr.hpp"
+
+class IHeuristic
+{
+public:
+    // Prepares estimates toward the node at targetIdx, csr has to stay valid while estimating
+    virtual void setTarget(const GraphCSR *csr, uint32_t targetIdx) = 0;
+
+    // Lower bound on the path weight from the node at idx to the target
+    virtual ll estimate(uint32_t idx) const = 0;
+
+    virtual ~IHeuristic() {}
+};
+
+// Straight line distance on the canvas scaled by the smallest weight a link has per pixel of its length
+// No path can weigh less than its length times that ratio, so the estimate stays a lower bound
+class EuclideanHeuristic : public IHeuristic
+{
+private:
+    const GraphCSR *csr;
+    double weightPerPixel;
+    sf::Vector2f target; // Position of the target node
+
+public:
+    // weightPerPixel has to be at most every link's weight divided by its length in pixels
+    EuclideanHeuristic(double weightPerPixel) : csr(NULL), weightPerPixel(weightPerPixel)
+    {
+        // Scaled down a hair so rounding can't push an estimate past the true weight
+        this->weightPerPixel *= 1 - 1e-9;
+    }
+
+    void setTarget(const GraphCSR *graphCSR, uint32_t targetIdx) override
+    {
+        csr = graphCSR;
+        target = csr->positions[targetIdx];
+    }
+
+    ll estimate(uint32_t idx) const override
+    {
+        sf::Vector2f d = csr->positions[idx] - target;
+        return (ll)std::floor(std::sqrt((double)d.x * d.x + (double)d.y * d.y) * weightPerPixel);
+    }
+
+    ~EuclideanHeuristic() override {}
+};
+
+// No estimate, A* searches exactly like Dijkstra
+class ZeroHeuristic : public IHeuristic
+{
+public:
+    void setTarget(const GraphCSR *graphCSR, uint32_t targetIdx) override {}
+
+    ll estimate(uint32_t idx) const override
+    {
+        return 0;
+    }
+
+    ~ZeroHeuristic() override {}
+};
@@ -0,0 +1,242 @@
+/*
+landmarks.hpp
+    - ALT (A*, landmarks, triangle inequality) lower bounds for repeated shortest path queries between graph edits
+    - Landmarks are picked farthest first, their distances are computed on a background thread from a copy of the CSR
+    - A table is only used for the graph version it was computed from, queries get no table while it is stale
+ */
+#pragma once
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include "graph.hpp"
+#include "heuristic.hpp"
+#include "dijkQueue.hpp"
+
+#define ALT_NUM_LANDMARKS 8
+#define ALT_SETTLE_MS 500 // Time the graph has to go unchanged before landmarks are computed again
+
+// Distances between every node and each landmark
+// Each direction is one array with a node's landmark distances side by side, an estimate reads 2 short runs of memory
+struct LandmarkTable
+{
+    size_t version;                  // Graph version the distances were computed for
+    size_t numNodes;                 // Size of the CSR the distances were computed for
+    std::vector<uint32_t> landmarks; // Dense indices of the landmarks
+    std::vector<ll> fromLandmark;    // <dense index * landmarks + landmark, weight from landmark to node> (-1 if unreachable)
+    std::vector<ll> toLandmark;      // <dense index * landmarks + landmark, weight from node to landmark> (-1 if unreachable)
+};
+
+// Dijkstra from root over csr's links, or over the links in reverse if backward is set
+// Queue is reset for every run since the monotone queues only accept keys past the last one popped
+inline void landmarkDistances(const GraphCSR &csr, uint32_t root, bool backward, ll maxWeight, DijkQueue &queue, std::vector<ll> &dist)
+{
+    queue.setType(DijkQueueType::Auto, maxWeight);
+    dist.assign(csr.numNodes(), -1);
+    dist[root] = 0;
+    queue.push(root, 0);
+    while (!queue.empty())
+    {
+        uint32_t currIdx = queue.pop();
+        for (uint32_t e = csr.edgesBegin(currIdx); e < csr.edgesEnd(currIdx); ++e)
+        {
+            if (backward ? !csr.canTravelBack(e) : !csr.canTravel(e))
+                continue;
+            uint32_t child = csr.targets[e];
+            ll newWeight = dist[currIdx] + csr.weights[e];
+            if (dist[child] == -1 || newWeight < dist[child])
+            {
+                dist[child] = newWeight;
+                queue.push(child, newWeight);
+            }
+        }
+    }
+}
+
+// Picks up to numLandmarks landmarks and fills table with their distances
+// Each landmark is the node farthest from the landmarks picked so far, nodes no landmark reaches are picked first
+inline void computeLandmarkTable(const GraphCSR &csr, size_t numLandmarks, size_t version, LandmarkTable &table)
+{
+    size_t numNodes = csr.numNodes();
+    table.version = version;
+    table.numNodes = numNodes;
+    table.landmarks.clear();
+
+    ll maxWeight = 0;
+    for (uint32_t idx = 0; idx < numNodes; ++idx)
+    {
+        for (uint32_t e = csr.edgesBegin(idx); e < csr.edgesEnd(idx); ++e)
+            maxWeight = std::max(maxWeight, csr.weights[e]);
+    }
+
+    // The first landmark is the node farthest from the first node
+    std::vector<ll> closest(numNodes, LLONG_MAX); // <dense index, weight from closest landmark> (LLONG_MAX if none reaches it)
+    std::vector<std::vector<ll>> from, to;
+    std::vector<ll> dist;
+    DijkQueue queue;
+    uint32_t next = UINT32_MAX;
+    for (uint32_t idx = 0; idx < numNodes && next == UINT32_MAX; ++idx)
+    {
+        if (csr.nodes[idx])
+            next = idx;
+    }
+    if (next == UINT32_MAX)
+        return;
+    landmarkDistances(csr, next, false, maxWeight, queue, dist);
+    for (uint32_t idx = 0; idx < numNodes; ++idx)
+    {
+        if (dist[idx] > dist[next])
+            next = idx;
+    }
+
+    while (table.landmarks.size() < numLandmarks)
+    {
+        table.landmarks.push_back(next);
+        from.push_back(std::vector<ll>());
+        to.push_back(std::vector<ll>());
+        landmarkDistances(csr, next, false, maxWeight, queue, from.back());
+        landmarkDistances(csr, next, true, maxWeight, queue, to.back());
+
+        // Next landmark is the node farthest from its closest landmark, stop when every node is a landmark
+        ll farthest = 0;
+        next = UINT32_MAX;
+        for (uint32_t idx = 0; idx < numNodes; ++idx)
+        {
+            if (!csr.nodes[idx])
+                continue;
+            if (from.back()[idx] != -1)
+                closest[idx] = std::min(closest[idx], from.back()[idx]);
+            if (closest[idx] > farthest)
+            {
+                farthest = closest[idx];
+                next = idx;
+            }
+        }
+        if (next == UINT32_MAX)
+            break;
+    }
+
+    size_t k = table.landmarks.size();
+    table.fromLandmark.assign(numNodes * k, -1);
+    table.toLandmark.assign(numNodes * k, -1);
+    for (size_t l = 0; l < k; ++l)
+    {
+        for (uint32_t idx = 0; idx < numNodes; ++idx)
+        {
+            table.fromLandmark[idx * k + l] = from[l][idx];
+            table.toLandmark[idx * k + l] = to[l][idx];
+        }
+    }
+}
+
+// Triangle inequality bounds through every landmark L: d(L, target) - d(L, node) and d(node, L) - d(target, L)
+// Bounds are skipped where a distance is unreachable, the largest bound left is the estimate
+class LandmarkHeuristic : public IHeuristic
+{
+private:
+    std::shared_ptr<const LandmarkTable> table;
+    size_t k;             // Number of landmarks
+    const ll *targetFrom; // Target's weights from each landmark
+    const ll *targetTo;   // Target's weights to each landmark
+
+public:
+    LandmarkHeuristic(const std::shared_ptr<const LandmarkTable> &landmarkTable) : table(landmarkTable), targetFrom(NULL), targetTo(NULL)
+    {
+        k = table->landmarks.size();
+    }
+
+    void setTarget(const GraphCSR *graphCSR, uint32_t targetIdx) override
+    {
+        assert(graphCSR->numNodes() == table->numNodes);
+        targetFrom = table->fromLandmark.data() + targetIdx * k;
+        targetTo = table->toLandmark.data() + targetIdx * k;
+    }
+
+    ll estimate(uint32_t idx) const override
+    {
+        const ll *from = table->fromLandmark.data() + idx * k;
+        const ll *to = table->toLandmark.data() + idx * k;
+        ll best = 0;
+        for (size_t l = 0; l < k; ++l)
+        {
+            if (from[l] != -1 && targetFrom[l] != -1 && targetFrom[l] - from[l] > best)
+                best = targetFrom[l] - from[l];
+            if (to[l] != -1 && targetTo[l] != -1 && to[l] - targetTo[l] > best)
+                best = to[l] - targetTo[l];
+        }
+        return best;
+    }
+
+    ~LandmarkHeuristic() override {}
+};
+
+// Keeps a landmark table for the graph, recomputing it on a background thread once edits to the graph settle
+class Landmarks
+{
+private:
+    std::shared_ptr<const LandmarkTable> table; // Last computed table (NULL if none)
+    std::shared_ptr<LandmarkTable> pending;     // Table the worker is filling (NULL if not computing)
+    std::thread worker;
+    std::atomic<bool> workerDone;
+    size_t seenVersion;                                // Graph version the last update saw
+    std::chrono::steady_clock::time_point changedTime; // When the last update saw the version change
+
+    // Worker thread, csr is the worker's own copy
+    static void compute(GraphCSR csr, size_t version, std::shared_ptr<LandmarkTable> out, std::atomic<bool> *done)
+    {
+        computeLandmarkTable(csr, ALT_NUM_LANDMARKS, version, *out);
+        done->store(true, std::memory_order_release);
+    }
+
+public:
+    Landmarks() : workerDone(false), seenVersion(SIZE_MAX) {}
+
+    // Called every frame A* with landmarks is picked, collects a finished table and starts a new one once the graph has gone unchanged for ALT_SETTLE_MS
+    void update(Graph &graph)
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (graph.getVersion() != seenVersion)
+        {
+            seenVersion = graph.getVersion();
+            changedTime = now;
+        }
+
+        // Tables finished after another edit are dropped, the next one starts once edits settle
+        if (pending && workerDone.load(std::memory_order_acquire))
+        {
+            worker.join();
+            if (pending->version == graph.getVersion())
+                table = pending;
+            pending.reset();
+        }
+
+        bool fresh = table && table->version == graph.getVersion();
+        bool settled = now - changedTime >= std::chrono::milliseconds(ALT_SETTLE_MS);
+        if (!fresh && !pending && settled && graph.getNumGraphs() > 0)
+        {
+            pending = std::make_shared<LandmarkTable>();
+            workerDone.store(false, std::memory_order_relaxed);
+            worker = std::thread(compute, graph.buildCSR(), graph.getVersion(), pending, &workerDone);
+        }
+    }
+
+    // Table for the graph as it is now, NULL while the graph has changed since the last table was computed
+    std::shared_ptr<const LandmarkTable> get(const Graph &graph) const
+    {
+        if (table && table->version == graph.getVersion())
+            return table;
+        return NULL;
+    }
+
+    inline bool isComputing() const
+    {
+        return pending != NULL;
+    }
+
+    ~Landmarks()
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+};
@@ -10,6 +10,9 @@ links class:
 #include <iostream>
 #include <stdlib.h>
 #include <string>
+#include <cstdint>
+#include <algorithm>
+#include "worldCells.hpp"
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -119,16 +122,121 @@ class Links
 {
 private:
     typedef long long ll;
+    static constexpr size_t NO_ARROW = SIZE_MAX;
+
+    // Where a link's drawables are stored
+    struct LinkSlot
+    {
+        size_t idx;   // Link's line is all_links[2*idx, 2*idx+1] and its weight is link_weights[idx]
+        size_t arrow; // Link's arrow is arrows[4*arrow, 4*arrow+3] (NO_ARROW if doubly linked)
+    };
+
     sf::Font font;
     std::vector<sf::Vertex> all_links;
-    std::unordered_map<std::string, size_t> nodes_links; // corresponding node identity to location of its link in all_links
     std::vector<sf::Vertex> arrows;
-    std::unordered_map<std::string, size_t> nodes_arrows; // bool cooresponding to whether nodes have an arrow (for singly linked)
     std::vector<sf::Text> link_weights;
-    std::unordered_map<std::string, size_t> nodes_weights;
+    std::unordered_map<uint64_t, LinkSlot> nodes_links; // <packed node identifiers, location of link's drawables>
+    std::vector<uint64_t> link_keys;                    // <link index, packed node identifiers> used to patch a link moved by removal
+    std::vector<uint64_t> arrow_keys;                   // <arrow index, packed node identifiers>
+    size_t revision;                                    // Bumped whenever a link is added, removed or reweighted
+
+    // Cell index of the lines for culling, each link is listed in every cell its line crosses
+    std::unordered_map<uint64_t, std::vector<uint32_t>> link_cells; // <cell key, indices of the links crossing the cell>
+    std::vector<uint64_t> cell_keys;                                // Cells of the line being indexed or unindexed
+    std::vector<uint32_t> link_seen;                                // <link index, query stamp the link was last collected at>
+    uint32_t seen_stamp;
+    std::vector<uint32_t> visible;                                  // Links collected by the last query
+    std::vector<sf::Vertex> visible_links;                          // Lines of the visible links, drawn in one call
+    std::vector<sf::Vertex> visible_arrows;                         // Arrows of the visible links, drawn in one call
+
+    void indexLink(uint32_t idx)
+    {
+        cell_keys.clear();
+        segmentCells(all_links[2 * idx].position, all_links[2 * idx + 1].position, cell_keys);
+        for (uint64_t key : cell_keys)
+            link_cells[key].push_back(idx);
+    }
+
+    void unindexLink(uint32_t idx)
+    {
+        cell_keys.clear();
+        segmentCells(all_links[2 * idx].position, all_links[2 * idx + 1].position, cell_keys);
+        for (uint64_t key : cell_keys)
+        {
+            std::unordered_map<uint64_t, std::vector<uint32_t>>::iterator found = link_cells.find(key);
+            if (found == link_cells.end())
+                continue;
+            std::vector<uint32_t> &cell = found->second;
+            for (size_t i = 0; i < cell.size(); ++i)
+            {
+                if (cell[i] == idx)
+                {
+                    cell[i] = cell.back();
+                    cell.pop_back();
+                    break;
+                }
+            }
+            if (cell.empty())
+                link_cells.erase(found);
+        }
+    }
+
+    // Adds the links of a cell not yet collected by the current query to visible
+    void collectCell(const std::vector<uint32_t> &cell)
+    {
+        for (uint32_t idx : cell)
+        {
+            if (link_seen[idx] == seen_stamp)
+                continue;
+            link_seen[idx] = seen_stamp;
+            visible.push_back(idx);
+        }
+    }
+
+    // packs two node identifiers into one key, the same for either order
+    inline static uint64_t linkKey(const ll &node1, const ll &node2)
+    {
+        uint64_t a = (uint32_t)node1, b = (uint32_t)node2;
+        return a < b ? (a << 32) | b : (b << 32) | a;
+    }
+
+    // moves the last link's line and weight into index idx and drops the last link
+    void swapPopLink(size_t idx)
+    {
+        size_t last = link_weights.size() - 1;
+        unindexLink(idx);
+        if (idx != last)
+        {
+            unindexLink(last);
+            all_links[2 * idx] = all_links[2 * last];
+            all_links[2 * idx + 1] = all_links[2 * last + 1];
+            link_weights[idx] = link_weights[last];
+            link_keys[idx] = link_keys[last];
+            nodes_links[link_keys[idx]].idx = idx;
+            indexLink(idx);
+        }
+        all_links.resize(2 * last);
+        link_weights.pop_back();
+        link_keys.pop_back();
+    }
+
+    // moves the last arrow into index idx and drops the last arrow
+    void swapPopArrow(size_t idx)
+    {
+        size_t last = arrow_keys.size() - 1;
+        if (idx != last)
+        {
+            for (size_t i = 0; i < 4; ++i)
+                arrows[4 * idx + i] = arrows[4 * last + i];
+            arrow_keys[idx] = arrow_keys[last];
+            nodes_links[arrow_keys[idx]].arrow = idx;
+        }
+        arrows.resize(4 * last);
+        arrow_keys.pop_back();
+    }
 
 public:
-    Links()
+    Links() : revision(0), seen_stamp(0)
     {
         if (!font.loadFromFile("./Dijkstras/fonts/open-sans/OpenSans-Semibold.ttf"))
         {
@@ -152,14 +260,11 @@ public:
 
     void updateLinkWeight(const ll &node1, const ll &node2, const ll &newWeight)
     {
-        std::string n_l_identifier1 = std::to_string(node1) + "_" + std::to_string(node2);
-
-        if (nodes_weights.count(n_l_identifier1))
+        auto it = nodes_links.find(linkKey(node1, node2));
+        if (it != nodes_links.end())
         {
-            size_t weightIdx = nodes_weights[n_l_identifier1];
-            sf::Text weight = link_weights[weightIdx];
-            weight.setString(std::to_string(newWeight));
-            link_weights[weightIdx] = weight;
+            link_weights[it->second.idx].setString(std::to_string(newWeight));
+            revision++;
         }
         else
         {
@@ -172,6 +277,13 @@ public:
     // point p1 is node that is pointing to point p2 if singly linked
     void addLink(const sf::Vector2f &p1, const sf::Vector2f &p2, const ll &node1, const ll &node2, const ll &weight, const LinkStat &lstate)
     {
+        uint64_t key = linkKey(node1, node2);
+        if (nodes_links.count(key))
+        {
+            std::cout << "LINKS - ERROR - setting identifiers: " << node1 << "_" << node2 << " already exists\n";
+            exit(EXIT_FAILURE);
+        }
+
         sf::Vector2f midpoint = lh::getLineMidpoint(p1, p2);
         // set link color based on link state
         sf::Color lcolor;
@@ -181,128 +293,119 @@ public:
             lcolor = SINGLY_COLOR;
 
         // add link based on color
+        LinkSlot slot;
+        slot.idx = link_weights.size();
+        slot.arrow = NO_ARROW;
         all_links.push_back(sf::Vertex(p1, lcolor));
         all_links.push_back(sf::Vertex(p2, lcolor));
 
-        // create node identifiers
-        std::string n_l_identifier1 = std::to_string(node1) + "_" + std::to_string(node2);
-        std::string n_l_identifier2 = std::to_string(node2) + "_" + std::to_string(node1);
-
         // update link weight values
         sf::Vector2f wp(midpoint.x + EDGE_WEIGHT_ORTH_DIST * cosf(lh::getLineAngle(p1, p2)), midpoint.y + EDGE_WEIGHT_ORTH_DIST * sinf(lh::getLineAngle(p1, p2)));
         link_weights.push_back(setTextInfo(weight, 10, sf::Color(255, 0, 0), lh::cwOrthRotation(wp, midpoint)));
-        size_t w_idx = link_weights.size() - 1;
-        nodes_weights[n_l_identifier1] = w_idx;
-        nodes_weights[n_l_identifier2] = w_idx;
-
-        // set node-link identifiers
-        // set arrow if singly linked
-        size_t l_idx = all_links.size() - 2;
-        if (!nodes_links.count(n_l_identifier1) && !nodes_links.count(n_l_identifier2))
+        link_keys.push_back(key);
+
+        // draw the arrow to show singly linked nodes (from -> to)
+        if (lstate == LinkStat::SinglyTo)
         {
-            nodes_links[n_l_identifier1] = l_idx;
-            nodes_links[n_l_identifier2] = l_idx;
+            sf::Vector2f ap1, ap2;
+            lh::getArrowPositions(p1, p2, midpoint, ap1, ap2);
 
-            // draw the arrow to show singly linked nodes (from -> to)
-            if (lstate == LinkStat::SinglyTo)
-            {
-                sf::Vector2f ap1, ap2;
-                lh::getArrowPositions(p1, p2, midpoint, ap1, ap2);
+            arrows.push_back(sf::Vertex(ap1, lcolor));
+            arrows.push_back(sf::Vertex(midpoint, lcolor));
 
-                arrows.push_back(sf::Vertex(ap1, lcolor));
-                arrows.push_back(sf::Vertex(midpoint, lcolor));
+            // bottom part of the arrow
+            arrows.push_back(sf::Vertex(ap2, lcolor));
+            arrows.push_back(sf::Vertex(midpoint, lcolor));
 
-                // bottom part of the arrow
-                // sf::Vector2f ap2(ARROW_LEN*(cosf(lineangle + M_PI_4)) + midpoint.x, -1*ARROW_LEN*(sinf(lineangle + M_PI_4)) + midpoint.y);
-                arrows.push_back(sf::Vertex(ap2, lcolor));
-                arrows.push_back(sf::Vertex(midpoint, lcolor));
+            // store location of the arrow from node identifier
+            slot.arrow = arrow_keys.size();
+            arrow_keys.push_back(key);
+        }
 
-                std::cout << "ap1.x: " << ap1.x << " ap1.y" << ap1.y << std::endl;
-                std::cout << "ap2.x: " << ap2.x << " ap2.y" << ap2.y << std::endl;
+        nodes_links[key] = slot;
+        indexLink(slot.idx);
+        revision++;
+    }
 
-                // store location of the arrow from node identifier
-                nodes_arrows[n_l_identifier1] = arrows.size() - 4;
-                nodes_arrows[n_l_identifier2] = arrows.size() - 4;
-            }
+    // removes the shared link between two nodes
+    // the last link is moved into the removed link's place so the vertex arrays stay contiguous
+    void removeLink(const ll &node1, const ll &node2)
+    {
+        auto it = nodes_links.find(linkKey(node1, node2));
+        if (it != nodes_links.end())
+        {
+            LinkSlot slot = it->second;
+            nodes_links.erase(it);
+
+            swapPopLink(slot.idx);
+            if (slot.arrow != NO_ARROW)
+                swapPopArrow(slot.arrow);
+            revision++;
         }
         else
         {
-            std::cout << "LINKS - ERROR - setting identifiers: " << n_l_identifier1 << " or " << n_l_identifier2 << " already exists\n";
-            exit(EXIT_FAILURE);
+            std::cout << "LINKS - ERROR - removing node linkage identifier: " << node1 << "_" << node2 << " has not been recorded\n";
         }
     }
 
-    // removes the shared link between two nodes
-    void removeLink(const ll &node1, const ll &node2)
+    // Changes whenever the drawn links do
+    inline size_t getRevision() const
     {
-        std::string n_l_identifier1 = std::to_string(node1) + "_" + std::to_string(node2);
-        std::string n_l_identifier2 = std::to_string(node2) + "_" + std::to_string(node1);
+        return revision;
+    }
 
-        if (nodes_links.count(n_l_identifier1) && nodes_links.count(n_l_identifier2))
+    // draws the links whose line crosses a cell rect overlaps, with their arrows and weights if detailed
+    void drawLinks(sf::RenderTarget *win, const sf::FloatRect &rect, bool detailed)
+    {
+        if (link_seen.size() < link_weights.size())
+            link_seen.resize(link_weights.size(), 0);
+        if (++seen_stamp == 0)
         {
-            size_t n_l_idx = nodes_links[n_l_identifier1];
-
-            // update node_link mappings greater than current index+1 to be deleted
-            for (auto it = nodes_links.begin(); it != nodes_links.end(); ++it)
-            {
-                if (it->second > n_l_idx + 1)
-                    it->second -= 2;
-            }
-
-            // erase link between two nodes
-            all_links.erase(all_links.begin() + n_l_idx, all_links.begin() + n_l_idx + 2);
-            // remove link mapping
-            nodes_links.erase(n_l_identifier1);
-            nodes_links.erase(n_l_identifier2);
+            std::fill(link_seen.begin(), link_seen.end(), 0);
+            seen_stamp = 1;
+        }
 
-            // erase edge weight
-            size_t w_idx = nodes_weights[n_l_identifier1];
-            for (auto it = nodes_weights.begin(); it != nodes_weights.end(); ++it)
+        // Rects spanning more cells than hold links walk the links' cells instead
+        visible.clear();
+        WorldCellRange range = worldCellsOf(rect);
+        if (range.count() > link_cells.size())
+        {
+            for (const std::pair<const uint64_t, std::vector<uint32_t>> &cell : link_cells)
             {
-                if (it->second > w_idx)
-                    it->second -= 1;
+                if (range.contains(cell.first))
+                    collectCell(cell.second);
             }
-
-            // remove gui edge weight
-            link_weights.erase(link_weights.begin() + w_idx);
-            // remove edge weight mapping
-            nodes_weights.erase(n_l_identifier1);
-            nodes_weights.erase(n_l_identifier2);
-
-            // if node has arrows
-            if (nodes_arrows.count(n_l_identifier1) && nodes_arrows.count(n_l_identifier2))
+        }
+        else
+        {
+            for (int y = range.y0; y <= range.y1; ++y)
             {
-                size_t a_l_idx = nodes_arrows[n_l_identifier1];
-
-                // update node_arrow mapping
-                for (auto it = nodes_arrows.begin(); it != nodes_arrows.end(); ++it)
+                for (int x = range.x0; x <= range.x1; ++x)
                 {
-                    if (it->second > a_l_idx + 3)
-                        it->second -= 4;
+                    std::unordered_map<uint64_t, std::vector<uint32_t>>::const_iterator found = link_cells.find(worldCellKey(x, y));
+                    if (found != link_cells.end())
+                        collectCell(found->second);
                 }
-
-                // remove the arrows
-                arrows.erase(arrows.begin() + a_l_idx, arrows.begin() + a_l_idx + 4);
-
-                // remove arrow mapping
-                nodes_arrows.erase(n_l_identifier1);
-                nodes_arrows.erase(n_l_identifier2);
             }
         }
-        else
-        {
-            std::cout << "LINKS - ERROR - removing node linkage identifier: " << n_l_identifier1 << " or " << n_l_identifier2 << " has not been recorded\n";
-        }
-    }
 
-    // draws all links and arrows to interface
-    inline void drawLinks(sf::RenderWindow *win)
-    {
-        win->draw(all_links.data(), all_links.size(), sf::Lines);
-        win->draw(arrows.data(), arrows.size(), sf::Lines);
-        for (int i = 0; i < link_weights.size(); ++i)
+        visible_links.clear();
+        visible_arrows.clear();
+        for (uint32_t idx : visible)
         {
-            win->draw(link_weights[i]);
+            visible_links.push_back(all_links[2 * idx]);
+            visible_links.push_back(all_links[2 * idx + 1]);
+            if (!detailed)
+                continue;
+            size_t arrow = nodes_links[link_keys[idx]].arrow;
+            if (arrow != NO_ARROW)
+                visible_arrows.insert(visible_arrows.end(), arrows.begin() + 4 * arrow, arrows.begin() + 4 * arrow + 4);
         }
+        win->draw(visible_links.data(), visible_links.size(), sf::Lines);
+        if (!detailed)
+            return;
+        win->draw(visible_arrows.data(), visible_arrows.size(), sf::Lines);
+        for (uint32_t idx : visible)
+            win->draw(link_weights[idx]);
     }
 };
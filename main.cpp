@@ -47,6 +47,7 @@ int main()
     Node *algoStartNode = NULL, *algoFindNode = NULL;
 
     sf::Vector2i left_mpos, curr_mpos;
+    sf::Vector2i pan_mpos; // Window pixel the camera was last panned from
     const int win_width = 1700;
     const int win_height = 750;
     const int simul_width = 1200;
@@ -70,8 +71,10 @@ int main()
     while (window.isOpen())
     {
         sf::Event event;
+        bool gotEvent = false;
         while (window.pollEvent(event))
         {
+            gotEvent = true;
             ImGui::SFML::ProcessEvent(event);
             switch (event.type)
             {
@@ -79,13 +82,29 @@ int main()
                 window.close();
                 break;
             case sf::Event::MouseButtonPressed:
+                // the camera pans in every mode
+                if (event.mouseButton.button == sf::Mouse::Middle)
+                {
+                    middlePressed = true;
+                    pan_mpos = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+                }
                 if (!textInputting && state != SimulState::ViewMode)
                 {
                     if (sf::Mouse::isButtonPressed(sf::Mouse::Left))
                     {
                         if (state == SimulState::AddNodeMode)
                         {
-                            game.addNode(&window);
+                            // pressing on a node drags it, pressing anywhere else adds a node
+                            left_clicked_on_node = game.mouseOverNode(&window, NODE_RADIUS);
+                            if (left_clicked_on_node)
+                            {
+                                dragging = true;
+                                left_mpos = game.mouseWorldPos(&window);
+                            }
+                            else
+                            {
+                                game.addNode(&window);
+                            }
                         }
                         else if (state == SimulState::AddLinkMode)
                         {
@@ -113,11 +132,7 @@ int main()
                     }
                     else if (sf::Mouse::isButtonPressed(sf::Mouse::Right))
                     {
-                        // Left for dragging
                         leftPressed = true;
-                        dragging = true;
-
-                        left_mpos = sf::Mouse::getPosition(window);
                         right_clicked_on_node = game.mouseOverNode(&window, NODE_RADIUS);
                         game.checkNodeExist(right_clicked_on_node);
                     }
@@ -125,6 +140,10 @@ int main()
                 break;
 
             case sf::Event::MouseButtonReleased:
+                if (event.mouseButton.button == sf::Mouse::Middle)
+                    middlePressed = false;
+                if (event.mouseButton.button == sf::Mouse::Left)
+                    dragging = false;
                 if (!textInputting && state != SimulState::ViewMode)
                 {
                     if (event.mouseButton.button == sf::Mouse::Left)
@@ -154,7 +173,6 @@ int main()
                     {
                         // delete node, when delete button toggled
                         leftPressed = false;
-                        dragging = false;
                         if (right_clicked_on_node)
                             std::cout << "was/is on node: " << right_clicked_on_node->getNodeIdent() << '\n';
                         right_clicked_on_node = NULL;
@@ -162,6 +180,24 @@ int main()
                 }
                 break;
 
+            case sf::Event::MouseMoved:
+                if (dragging)
+                    game.onDragNode(&window, left_clicked_on_node, left_mpos, dragging);
+                if (middlePressed)
+                {
+                    curr_mpos = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+                    game.panCamera(curr_mpos - pan_mpos);
+                    pan_mpos = curr_mpos;
+                }
+                break;
+
+            case sf::Event::MouseWheelScrolled:
+                // zoom around the mouse unless ImGui is scrolling one of its windows
+                curr_mpos = sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                if (event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel && game.pixelInSimul(curr_mpos) && !ImGui::GetIO().WantCaptureMouse)
+                    game.zoomCamera(event.mouseWheelScroll.delta, curr_mpos);
+                break;
+
             case sf::Event::KeyPressed:
                 if (!textInputting && state != SimulState::ViewMode)
                 {
@@ -214,6 +250,15 @@ int main()
             }
         }
 
+        // Any input can change the graph or ImGui, without any and without changes of its own only ImGui's throttled idle frames are drawn
+        if (gotEvent)
+            game.markSceneDirty();
+        if (!game.frameNeeded())
+        {
+            sf::sleep(sf::milliseconds(GUI_IDLE_SLEEP_MS));
+            continue;
+        }
+
         ImGui::SFML::Update(window, deltaClock.restart());
         // handle shadow links for adding and removing links
         if (state == SimulState::AddLinkMode)
@@ -0,0 +1,279 @@
+/*
+nodeVisuals.hpp
+    - Interface look of every node kept in arrays by dense index, apart from the nodes and their links
+    - Every circle is a pair of quads in one vertex array over a generated disk texture, every label is glyph quads in another over the font's atlas
+    - Drawing any set of nodes is one draw call for the circles and one for the labels, color changes only rewrite the node's own vertices
+ */
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+
+#define NODE_RADIUS 30
+#define NODE_FILL_COLOR sf::Color::Blue
+#define NODE_OUT_COLOR sf::Color::White
+#define NODE_TEXT_COLOR sf::Color::Red
+
+#define NODE_OUTLINE_THICKNESS 2.f // Outline drawn past the radius
+#define NODE_LABEL_SIZE 18         // Character size of the identifier labels
+#define NODE_DISK_TEXTURE_SIZE 128 // Width and height of the disk texture the circles sample
+#define NODE_CIRCLE_VERTS 8        // Outline quad then fill quad
+
+// How much of a node is drawn, less as nodes get smaller on screen
+enum class NodeDetail
+{
+    Labeled, // Circle and identifier label
+    Plain,   // Circle only
+    Point    // A point in the fill color
+};
+
+class NodeVisuals
+{
+private:
+    sf::Texture disk;        // White anti-aliased disk, tinted by the vertex colors
+    const sf::Font *font;    // Font of the labels, its atlas is the labels' texture (NULL until a node is added)
+
+    std::vector<uint8_t> used;               // <dense index, whether a node has the index>
+    std::vector<sf::Vector2f> positions;     // <dense index, center of the node>
+    std::vector<sf::Vertex> circles;         // <dense index * NODE_CIRCLE_VERTS, quads of the node's circle>
+    std::vector<sf::Vertex> labels;          // Glyph quads of every label, 4 vertices per character
+    std::vector<uint32_t> labelBegin;        // <dense index, first character of the node's label in labels>
+    std::vector<uint32_t> labelChars;        // <dense index, characters of the node's label>
+    std::vector<uint32_t> labelCapacity;     // <dense index, characters the node's range of labels has room for>
+    size_t revision;                         // Bumped whenever any vertex changes
+    std::vector<sf::Vertex> visibleCircles;  // Circles or points of the nodes drawSome was last given
+    std::vector<sf::Vertex> visibleLabels;   // Labels of the nodes drawSome was last given
+
+    // Disk of radius NODE_DISK_TEXTURE_SIZE / 2 - 1 with a one pixel soft edge, so scaled quads stay smooth
+    void createDiskTexture()
+    {
+        const unsigned size = NODE_DISK_TEXTURE_SIZE;
+        const float center = size / 2.f;
+        const float radius = center - 1.f;
+
+        sf::Image image;
+        image.create(size, size, sf::Color::Transparent);
+        for (unsigned y = 0; y < size; ++y)
+        {
+            for (unsigned x = 0; x < size; ++x)
+            {
+                float dx = x + 0.5f - center;
+                float dy = y + 0.5f - center;
+                float cover = radius - std::sqrt(dx * dx + dy * dy) + 0.5f;
+                cover = cover < 0.f ? 0.f : (cover > 1.f ? 1.f : cover);
+                image.setPixel(x, y, sf::Color(255, 255, 255, (sf::Uint8)(cover * 255)));
+            }
+        }
+        disk.loadFromImage(image);
+        disk.setSmooth(true);
+    }
+
+    // Writes the quad of a disk of radius r centered at pos into the 4 vertices at quad
+    static void placeDisk(sf::Vertex *quad, const sf::Vector2f &pos, float r)
+    {
+        // The disk in the texture stops a pixel short of the edge
+        const float half = NODE_DISK_TEXTURE_SIZE / 2.f;
+        float extent = r * half / (half - 1.f);
+
+        quad[0].position = sf::Vector2f(pos.x - extent, pos.y - extent);
+        quad[1].position = sf::Vector2f(pos.x + extent, pos.y - extent);
+        quad[2].position = sf::Vector2f(pos.x + extent, pos.y + extent);
+        quad[3].position = sf::Vector2f(pos.x - extent, pos.y + extent);
+        quad[0].texCoords = sf::Vector2f(0.f, 0.f);
+        quad[1].texCoords = sf::Vector2f(NODE_DISK_TEXTURE_SIZE, 0.f);
+        quad[2].texCoords = sf::Vector2f(NODE_DISK_TEXTURE_SIZE, NODE_DISK_TEXTURE_SIZE);
+        quad[3].texCoords = sf::Vector2f(0.f, NODE_DISK_TEXTURE_SIZE);
+    }
+
+    // Collapses count vertices to a point so they draw nothing
+    static void hide(sf::Vertex *verts, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            verts[i] = sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Color::Transparent);
+    }
+
+    // Lays out the label's glyph quads centered on the node, reusing the node's range of labels if the label fits
+    void setLabel(uint32_t idx, const std::string &label)
+    {
+        if (label.size() > labelCapacity[idx])
+        {
+            hide(labels.data() + 4 * labelBegin[idx], 4 * labelCapacity[idx]);
+            labelBegin[idx] = labels.size() / 4;
+            labelCapacity[idx] = label.size();
+            labels.resize(labels.size() + 4 * label.size());
+        }
+        sf::Vertex *quads = labels.data() + 4 * labelBegin[idx];
+        hide(quads, 4 * labelCapacity[idx]);
+        labelChars[idx] = label.size();
+
+        // Glyphs along a baseline at y = 0, then moved so their bounds are centered on the node
+        float x = 0.f;
+        sf::Vector2f low(0.f, 0.f), high(0.f, 0.f);
+        for (size_t c = 0; c < label.size(); ++c)
+        {
+            if (c > 0)
+                x += font->getKerning(label[c - 1], label[c], NODE_LABEL_SIZE);
+            const sf::Glyph &glyph = font->getGlyph(label[c], NODE_LABEL_SIZE, false);
+            float left = x + glyph.bounds.left;
+            float top = glyph.bounds.top;
+            float right = left + glyph.bounds.width;
+            float bottom = top + glyph.bounds.height;
+            float u1 = glyph.textureRect.left;
+            float v1 = glyph.textureRect.top;
+            float u2 = u1 + glyph.textureRect.width;
+            float v2 = v1 + glyph.textureRect.height;
+
+            sf::Vertex *quad = quads + 4 * c;
+            quad[0] = sf::Vertex(sf::Vector2f(left, top), NODE_TEXT_COLOR, sf::Vector2f(u1, v1));
+            quad[1] = sf::Vertex(sf::Vector2f(right, top), NODE_TEXT_COLOR, sf::Vector2f(u2, v1));
+            quad[2] = sf::Vertex(sf::Vector2f(right, bottom), NODE_TEXT_COLOR, sf::Vector2f(u2, v2));
+            quad[3] = sf::Vertex(sf::Vector2f(left, bottom), NODE_TEXT_COLOR, sf::Vector2f(u1, v2));
+
+            if (c == 0 || left < low.x)
+                low.x = left;
+            if (c == 0 || top < low.y)
+                low.y = top;
+            if (c == 0 || right > high.x)
+                high.x = right;
+            if (c == 0 || bottom > high.y)
+                high.y = bottom;
+            x += glyph.advance;
+        }
+
+        sf::Vector2f shift = positions[idx] - (low + high) / 2.f;
+        for (size_t v = 0; v < 4 * label.size(); ++v)
+            quads[v].position += shift;
+    }
+
+public:
+    NodeVisuals() : font(NULL), revision(0)
+    {
+        createDiskTexture();
+    }
+
+    // Gives the node at a dense index its default look, the index may be one a removed node had
+    void add(uint32_t idx, const std::string &label, const sf::Vector2f &pos, const sf::Font &labelFont)
+    {
+        revision++;
+        if (idx >= used.size())
+        {
+            used.resize(idx + 1, 0);
+            positions.resize(idx + 1);
+            circles.resize((idx + 1) * NODE_CIRCLE_VERTS, sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Color::Transparent));
+            labelBegin.resize(idx + 1, 0);
+            labelChars.resize(idx + 1, 0);
+            labelCapacity.resize(idx + 1, 0);
+        }
+
+        font = &labelFont;
+        used[idx] = 1;
+        positions[idx] = pos;
+
+        sf::Vertex *circle = circles.data() + idx * NODE_CIRCLE_VERTS;
+        placeDisk(circle, pos, NODE_RADIUS + NODE_OUTLINE_THICKNESS);
+        placeDisk(circle + 4, pos, NODE_RADIUS);
+        setOutlineColor(idx, NODE_OUT_COLOR);
+        setFillColor(idx, NODE_FILL_COLOR);
+        setLabel(idx, label);
+    }
+
+    // Hides the node's vertices, its range of labels is kept for the next node given the index
+    void remove(uint32_t idx)
+    {
+        revision++;
+        used[idx] = 0;
+        hide(circles.data() + idx * NODE_CIRCLE_VERTS, NODE_CIRCLE_VERTS);
+        hide(labels.data() + 4 * labelBegin[idx], 4 * labelCapacity[idx]);
+        labelChars[idx] = 0;
+    }
+
+    void setPosition(uint32_t idx, const sf::Vector2f &pos)
+    {
+        revision++;
+        sf::Vector2f shift = pos - positions[idx];
+        positions[idx] = pos;
+
+        sf::Vertex *circle = circles.data() + idx * NODE_CIRCLE_VERTS;
+        for (size_t v = 0; v < NODE_CIRCLE_VERTS; ++v)
+            circle[v].position += shift;
+        sf::Vertex *quads = labels.data() + 4 * labelBegin[idx];
+        for (size_t v = 0; v < 4 * labelChars[idx]; ++v)
+            quads[v].position += shift;
+    }
+
+    // Color setters leave the revision alone when the color doesn't change, replayed steps often set the same one
+    inline void setFillColor(uint32_t idx, const sf::Color &color)
+    {
+        sf::Vertex *quad = circles.data() + idx * NODE_CIRCLE_VERTS + 4;
+        if (quad[0].color == color)
+            return;
+        revision++;
+        for (size_t v = 0; v < 4; ++v)
+            quad[v].color = color;
+    }
+
+    inline void setOutlineColor(uint32_t idx, const sf::Color &color)
+    {
+        sf::Vertex *quad = circles.data() + idx * NODE_CIRCLE_VERTS;
+        if (quad[0].color == color)
+            return;
+        revision++;
+        for (size_t v = 0; v < 4; ++v)
+            quad[v].color = color;
+    }
+
+    inline void setTextColor(uint32_t idx, const sf::Color &color)
+    {
+        sf::Vertex *quads = labels.data() + 4 * labelBegin[idx];
+        if (labelChars[idx] == 0 || quads[0].color == color)
+            return;
+        revision++;
+        for (size_t v = 0; v < 4 * labelChars[idx]; ++v)
+            quads[v].color = color;
+    }
+
+    // Changes whenever the drawn nodes do
+    inline size_t getRevision() const
+    {
+        return revision;
+    }
+
+    // Draws the node at a dense index
+    void draw(uint32_t idx, sf::RenderTarget *win)
+    {
+        win->draw(circles.data() + idx * NODE_CIRCLE_VERTS, NODE_CIRCLE_VERTS, sf::Quads, sf::RenderStates(&disk));
+        if (labelChars[idx] > 0)
+            win->draw(labels.data() + 4 * labelBegin[idx], 4 * labelChars[idx], sf::Quads, sf::RenderStates(&font->getTexture(NODE_LABEL_SIZE)));
+    }
+
+    // Draws the nodes at the given dense indices in their order at a level of detail, labels go over all circles
+    // Their vertices are gathered into one batch for the circles or points and one for the labels
+    void drawSome(const std::vector<uint32_t> &idxs, sf::RenderTarget *win, NodeDetail detail)
+    {
+        if (!font)
+            return;
+        visibleCircles.clear();
+        visibleLabels.clear();
+        if (detail == NodeDetail::Point)
+        {
+            for (uint32_t idx : idxs)
+                visibleCircles.push_back(sf::Vertex(positions[idx], circles[idx * NODE_CIRCLE_VERTS + 4].color));
+            win->draw(visibleCircles.data(), visibleCircles.size(), sf::Points);
+            return;
+        }
+
+        for (uint32_t idx : idxs)
+        {
+            const sf::Vertex *circle = circles.data() + idx * NODE_CIRCLE_VERTS;
+            visibleCircles.insert(visibleCircles.end(), circle, circle + NODE_CIRCLE_VERTS);
+            if (detail != NodeDetail::Labeled)
+                continue;
+            const sf::Vertex *quads = labels.data() + 4 * labelBegin[idx];
+            visibleLabels.insert(visibleLabels.end(), quads, quads + 4 * labelChars[idx]);
+        }
+        win->draw(visibleCircles.data(), visibleCircles.size(), sf::Quads, sf::RenderStates(&disk));
+        win->draw(visibleLabels.data(), visibleLabels.size(), sf::Quads, sf::RenderStates(&font->getTexture(NODE_LABEL_SIZE)));
+    }
+};
@@ -0,0 +1,95 @@
+/*
+slotmap.hpp
+    - Slot map from node identifiers to the nodes' dense indices
+    - Each dense index (slot) carries a generation that changes when the slot is freed, so lookups through stale identifiers are detected
+ */
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "node.hpp"
+
+// Slot and the generation the slot had when the node was placed in it
+struct NodeHandle
+{
+    uint32_t slot;
+    uint32_t gen;
+};
+
+class NodeSlots
+{
+private:
+    std::vector<Node *> nodes;          // <slot, Node> (NULL if the slot is free)
+    std::vector<uint32_t> gens;         // <slot, generation of the slot>
+    std::vector<uint32_t> freeSlots;    // Slots freed by deleted nodes, reused by new nodes
+    std::vector<NodeHandle> identSlots; // <node identifier, handle the node was given>
+
+public:
+    NodeSlots() {}
+
+    // Places node n with identifier ident in a slot and returns the slot
+    uint32_t insert(ll ident, Node *n)
+    {
+        uint32_t slot = nodes.size();
+        if (freeSlots.size() > 0)
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            nodes[slot] = n;
+        }
+        else
+        {
+            nodes.push_back(n);
+            gens.push_back(0);
+        }
+
+        // identifiers are handed out in increasing order so the table stays dense
+        if (ident >= (ll)identSlots.size())
+            identSlots.resize(ident + 1, NodeHandle{UINT32_MAX, 0});
+        identSlots[ident] = NodeHandle{slot, gens[slot]};
+        return slot;
+    }
+
+    // Frees a slot, handles to the slot's old node become stale
+    void erase(uint32_t slot)
+    {
+        assert(slot < nodes.size() && nodes[slot]);
+        nodes[slot] = NULL;
+        gens[slot]++;
+        freeSlots.push_back(slot);
+    }
+
+    // Returns the handle given to the node with identifier ident (slot is UINT32_MAX if it never existed)
+    inline NodeHandle getHandle(ll ident) const
+    {
+        if (ident < 0 || ident >= (ll)identSlots.size())
+            return NodeHandle{UINT32_MAX, 0};
+        return identSlots[ident];
+    }
+
+    // Returns the node a handle points to or NULL if the handle is stale
+    inline Node *get(const NodeHandle &h) const
+    {
+        if (h.slot >= nodes.size() || gens[h.slot] != h.gen)
+            return NULL;
+        return nodes[h.slot];
+    }
+
+    // Returns the node with identifier ident or NULL if it doesn't exist anymore
+    inline Node *find(ll ident) const
+    {
+        return get(getHandle(ident));
+    }
+
+    // <slot, Node> table of every slot
+    inline const std::vector<Node *> &getNodes() const
+    {
+        return nodes;
+    }
+
+    // Number of slots, including free slots
+    inline size_t size() const
+    {
+        return nodes.size();
+    }
+};
@@ -0,0 +1,96 @@
+/*
+spatialGrid.hpp
+    - Sparse bucket grid of node centers for hit testing and culling
+    - Only cells holding nodes are kept, so it covers the whole world space whatever its size
+ */
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <algorithm>
+#include <SFML/Graphics.hpp>
+#include "node.hpp"
+#include "worldCells.hpp"
+
+class SpatialGrid
+{
+private:
+    std::unordered_map<uint64_t, std::vector<Node *>> cells; // <cell key, nodes whose center lies in the cell>
+
+    inline static uint64_t cellOf(const sf::Vector2i &pos)
+    {
+        return worldCellKey(worldCell(pos.x), worldCell(pos.y));
+    }
+
+    // Appends the nodes of cell whose center lies in rect
+    static void collect(const std::vector<Node *> &cell, const sf::FloatRect &rect, std::vector<Node *> &out)
+    {
+        for (Node *n : cell)
+        {
+            sf::Vector2f npos = n->getNodePos();
+            if (npos.x >= rect.left && npos.x <= rect.left + rect.width && npos.y >= rect.top && npos.y <= rect.top + rect.height)
+                out.push_back(n);
+        }
+    }
+
+public:
+    void insert(Node *n, const sf::Vector2i &pos)
+    {
+        cells[cellOf(pos)].push_back(n);
+    }
+
+    // Removes n, pos is the position n was inserted or last moved at
+    void remove(Node *n, const sf::Vector2i &pos)
+    {
+        std::unordered_map<uint64_t, std::vector<Node *>>::iterator found = cells.find(cellOf(pos));
+        if (found == cells.end())
+            return;
+        std::vector<Node *> &cell = found->second;
+        std::vector<Node *>::iterator it = std::find(cell.begin(), cell.end(), n);
+        if (it != cell.end())
+        {
+            *it = cell.back();
+            cell.pop_back();
+        }
+        if (cell.empty())
+            cells.erase(found);
+    }
+
+    void move(Node *n, const sf::Vector2i &oldPos, const sf::Vector2i &newPos)
+    {
+        if (cellOf(oldPos) == cellOf(newPos))
+            return;
+        remove(n, oldPos);
+        insert(n, newPos);
+    }
+
+    // Appends every node whose center lies in the square of the given radius around pos
+    void query(const sf::Vector2i &pos, size_t radius, std::vector<Node *> &out) const
+    {
+        float r = radius;
+        queryRect(sf::FloatRect(pos.x - r, pos.y - r, 2 * r, 2 * r), out);
+    }
+
+    // Appends every node whose center lies in rect
+    // Rects spanning more cells than hold nodes walk the nodes' cells instead, so zoomed out views cost at most the graph
+    void queryRect(const sf::FloatRect &rect, std::vector<Node *> &out) const
+    {
+        WorldCellRange range = worldCellsOf(rect);
+        if (range.count() > cells.size())
+        {
+            for (const std::pair<const uint64_t, std::vector<Node *>> &cell : cells)
+                collect(cell.second, rect, out);
+            return;
+        }
+
+        for (int y = range.y0; y <= range.y1; ++y)
+        {
+            for (int x = range.x0; x <= range.x1; ++x)
+            {
+                std::unordered_map<uint64_t, std::vector<Node *>>::const_iterator found = cells.find(worldCellKey(x, y));
+                if (found != cells.end())
+                    collect(found->second, rect, out);
+            }
+        }
+    }
+};
@@ -0,0 +1,67 @@
+/*
+stepLog.hpp
+    - Append only log of the node state changes made at each algorithm step
+    - Every step's changes are packed in one array, a step's nodes of one state are read back from the step's range
+ */
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+// Node states recorded per step
+enum class VisNodesVec : uint8_t
+{
+    current,
+    reachable,
+    visited,
+    visitedBack // Visited by a search running back from the find node
+};
+
+class StepLog
+{
+private:
+    std::vector<uint32_t> events;     // <event, dense index << 2 | VisNodesVec>
+    std::vector<uint32_t> stepStarts; // <step, first event of the step>
+
+public:
+    StepLog() {}
+
+    // Records the node at idx entering state at step, steps have to be recorded in order
+    void add(size_t step, VisNodesVec state, uint32_t idx)
+    {
+        assert(step + 1 >= stepStarts.size());
+        assert(idx < (1u << 30));
+        while (stepStarts.size() <= step)
+            stepStarts.push_back(events.size());
+        events.push_back(idx << 2 | (uint32_t)state);
+    }
+
+    // Events of a step are [stepBegin(step), stepEnd(step)), empty if nothing was recorded at step
+    inline uint32_t stepBegin(size_t step) const
+    {
+        return step < stepStarts.size() ? stepStarts[step] : events.size();
+    }
+
+    inline uint32_t stepEnd(size_t step) const
+    {
+        return step + 1 < stepStarts.size() ? stepStarts[step + 1] : events.size();
+    }
+
+    inline VisNodesVec state(uint32_t e) const
+    {
+        return (VisNodesVec)(events[e] & 3);
+    }
+
+    // Dense index of the event's node
+    inline uint32_t node(uint32_t e) const
+    {
+        return events[e] >> 2;
+    }
+
+    void clear()
+    {
+        events.clear();
+        stepStarts.clear();
+    }
+};
@@ -0,0 +1,193 @@
+/*
+threadPool.hpp
+    - Work stealing thread pool for splitting loops over many nodes across every core
+    - Each worker keeps a deque of index ranges, halving big ranges onto its own back and stealing from the front of others when it runs dry
+ */
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Loop body of parallelFor, run is called from every worker at once on separate ranges
+class IRangeTask
+{
+public:
+    // Runs the task over indices [begin, end), worker is below the pool's number of workers
+    virtual void run(size_t begin, size_t end, unsigned worker) = 0;
+
+    virtual ~IRangeTask() {}
+};
+
+class WorkStealingPool
+{
+private:
+    struct Range
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    // Ranges are taken off the back by the owner and off the front by thieves, so thieves take the biggest halves
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::thread> threads;             // Workers 1 and up, the caller of parallelFor is worker 0
+    std::vector<std::unique_ptr<Worker>> workers; // <worker, its ranges>
+
+    // Job the threads are woken up for
+    std::mutex jobLock;
+    std::condition_variable jobStart;
+    std::condition_variable jobDone;
+    size_t jobId;              // Bumped for every job so sleeping threads notice a new one
+    unsigned busyThreads;      // Threads still working on the current job
+    bool stopping;             // Set when the pool is destroyed
+    IRangeTask *task;          // Task of the current job
+    size_t grain;              // Ranges at most this long are run instead of split
+    std::atomic<size_t> left;  // Indices of the current job not yet run
+
+    void push(unsigned w, const Range &r)
+    {
+        std::lock_guard<std::mutex> guard(workers[w]->lock);
+        workers[w]->ranges.push_back(r);
+    }
+
+    bool popOwn(unsigned w, Range &r)
+    {
+        std::lock_guard<std::mutex> guard(workers[w]->lock);
+        if (workers[w]->ranges.empty())
+            return false;
+        r = workers[w]->ranges.back();
+        workers[w]->ranges.pop_back();
+        return true;
+    }
+
+    // Takes the oldest range of the first other worker that has one, starting after w so thieves spread out
+    bool steal(unsigned w, Range &r)
+    {
+        for (size_t i = 1; i < workers.size(); ++i)
+        {
+            Worker &victim = *workers[(w + i) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.ranges.empty())
+            {
+                r = victim.ranges.front();
+                victim.ranges.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Runs ranges of the current job until every index has been run
+    void work(unsigned w)
+    {
+        Range r;
+        while (left.load(std::memory_order_acquire) > 0)
+        {
+            if (!popOwn(w, r) && !steal(w, r))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Big ranges are halved so idle workers have something to steal
+            while (r.end - r.begin > grain)
+            {
+                size_t mid = r.begin + (r.end - r.begin) / 2;
+                push(w, Range{mid, r.end});
+                r.end = mid;
+            }
+            task->run(r.begin, r.end, w);
+            left.fetch_sub(r.end - r.begin, std::memory_order_acq_rel);
+        }
+    }
+
+    void threadMain(unsigned w)
+    {
+        size_t seenJob = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> guard(jobLock);
+                while (!stopping && jobId == seenJob)
+                    jobStart.wait(guard);
+                if (stopping)
+                    return;
+                seenJob = jobId;
+            }
+
+            work(w);
+
+            std::lock_guard<std::mutex> guard(jobLock);
+            if (--busyThreads == 0)
+                jobDone.notify_all();
+        }
+    }
+
+public:
+    // Starts numWorkers - 1 threads, the caller of parallelFor works as worker 0
+    WorkStealingPool(unsigned numWorkers = std::thread::hardware_concurrency())
+        : jobId(0), busyThreads(0), stopping(false), task(NULL), grain(1), left(0)
+    {
+        if (numWorkers == 0)
+            numWorkers = 1;
+        for (unsigned w = 0; w < numWorkers; ++w)
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        for (unsigned w = 1; w < numWorkers; ++w)
+            threads.push_back(std::thread(&WorkStealingPool::threadMain, this, w));
+    }
+
+    inline unsigned numWorkers() const
+    {
+        return workers.size();
+    }
+
+    // Runs t over [0, n) split into ranges of at most rangeGrain indices, returns once all of them ran
+    // Small loops are run on the calling thread without waking the pool
+    void parallelFor(size_t n, size_t rangeGrain, IRangeTask &t)
+    {
+        if (n == 0)
+            return;
+        if (threads.empty() || n <= rangeGrain)
+        {
+            t.run(0, n, 0);
+            return;
+        }
+
+        task = &t;
+        grain = rangeGrain > 0 ? rangeGrain : 1;
+        left.store(n, std::memory_order_release);
+        push(0, Range{0, n});
+        {
+            std::lock_guard<std::mutex> guard(jobLock);
+            jobId++;
+            busyThreads = threads.size();
+        }
+        jobStart.notify_all();
+
+        work(0);
+
+        // Threads that woke up late still have to see the job as done before the next one starts
+        std::unique_lock<std::mutex> guard(jobLock);
+        while (busyThreads > 0)
+            jobDone.wait(guard);
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(jobLock);
+            stopping = true;
+        }
+        jobStart.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+};
@@ -0,0 +1,85 @@
+/*
+worldCells.hpp
+    - Square cells of world space that the node and link indices bucket into
+    - Cells are only keyed, not allocated, so the world can be far bigger than what holds nodes
+ */
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+
+#define WORLD_CELL_SIZE 256 // Width and height of a cell in world units, a few nodes fit in one at the closest they can be placed
+
+// Cell coordinate of a world coordinate
+inline int worldCell(float p)
+{
+    return (int)std::floor(p / WORLD_CELL_SIZE);
+}
+
+inline uint64_t worldCellKey(int cx, int cy)
+{
+    return ((uint64_t)(uint32_t)cy << 32) | (uint32_t)cx;
+}
+
+// Cells a rectangle overlaps, both ends inclusive
+struct WorldCellRange
+{
+    int x0, y0, x1, y1;
+
+    inline size_t count() const
+    {
+        return (size_t)(x1 - x0 + 1) * (size_t)(y1 - y0 + 1);
+    }
+
+    inline bool contains(uint64_t key) const
+    {
+        int cx = (int32_t)(uint32_t)key, cy = (int32_t)(uint32_t)(key >> 32);
+        return cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1;
+    }
+};
+
+inline WorldCellRange worldCellsOf(const sf::FloatRect &rect)
+{
+    WorldCellRange r;
+    r.x0 = worldCell(rect.left);
+    r.y0 = worldCell(rect.top);
+    r.x1 = worldCell(rect.left + rect.width);
+    r.y1 = worldCell(rect.top + rect.height);
+    return r;
+}
+
+// Appends the keys of the cells the segment from a to b passes through, in order from a
+// Steps one cell border at a time, so long links only cost the cells they actually cross
+inline void segmentCells(const sf::Vector2f &a, const sf::Vector2f &b, std::vector<uint64_t> &out)
+{
+    int cx = worldCell(a.x), cy = worldCell(a.y);
+    int ex = worldCell(b.x), ey = worldCell(b.y);
+    out.push_back(worldCellKey(cx, cy));
+
+    float dx = b.x - a.x, dy = b.y - a.y;
+    int stepX = dx > 0 ? 1 : -1, stepY = dy > 0 ? 1 : -1;
+
+    // Fraction of the segment to the next border on each axis and between borders
+    float nextX = dx != 0 ? ((stepX > 0 ? cx + 1 : cx) * (float)WORLD_CELL_SIZE - a.x) / dx : INFINITY;
+    float nextY = dy != 0 ? ((stepY > 0 ? cy + 1 : cy) * (float)WORLD_CELL_SIZE - a.y) / dy : INFINITY;
+    float acrossX = dx != 0 ? WORLD_CELL_SIZE / std::fabs(dx) : INFINITY;
+    float acrossY = dy != 0 ? WORLD_CELL_SIZE / std::fabs(dy) : INFINITY;
+
+    // Counting the steps left keeps rounding from walking past the last cell
+    for (int left = std::abs(ex - cx) + std::abs(ey - cy); left > 0; --left)
+    {
+        if (cy == ey || (cx != ex && nextX < nextY))
+        {
+            cx += stepX;
+            nextX += acrossX;
+        }
+        else
+        {
+            cy += stepY;
+            nextY += acrossY;
+        }
+        out.push_back(worldCellKey(cx, cy));
+    }
+}